@@ -0,0 +1,97 @@
+#include "counters.hpp"
+#include <mutex>
+using namespace std;
+
+static const char *const counter_names[counter_amount] = {
+    "rank",
+    "select",
+    "next_one",
+    "init_slate",
+    "make_static",
+    "array_init",
+    "get_pos",
+    "stack_drop",
+    "stack_dropped",
+    "dfs_restore",
+    "dfs_restore_pops"
+};
+
+// all living threads and sum of finished threads
+struct counter_registry{
+    std::mutex lock;
+    std::vector<ThreadCounters*> threads;
+    uint64_t finished[counter_amount]={};
+};
+
+// constructed on first use, outlives all thread_local counters
+static counter_registry &registry(){
+    static counter_registry *instance = new counter_registry();
+    return *instance;
+}
+
+ThreadCounters::ThreadCounters(){
+    for (auto &value: values)
+        value.store(0, std::memory_order_relaxed);
+    counter_registry &reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.threads.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters(){
+    counter_registry &reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (uint8_t counter=0; counter<counter_amount; counter++)
+        reg.finished[counter] += values[counter].load(std::memory_order_relaxed);
+    for (auto it=reg.threads.begin(); it!=reg.threads.end(); it++){
+        if (*it==this){
+            reg.threads.erase(it);
+            break;
+        }
+    }
+}
+
+bool counters_enabled() noexcept{
+#ifdef SFL_COUNTERS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *counter_name(const sfl_counter counter) noexcept{
+    if (counter>=counter_amount)
+        return "invalid";
+    return counter_names[counter];
+}
+
+std::vector<std::pair<std::string, uint64_t>> counters_snapshot(){
+    std::vector<std::pair<std::string, uint64_t>> ret;
+    counter_registry &reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (uint8_t counter=0; counter<counter_amount; counter++){
+        uint64_t sum = reg.finished[counter];
+        for (const ThreadCounters *thread: reg.threads)
+            sum += thread->values[counter].load(std::memory_order_relaxed);
+        ret.emplace_back(counter_names[counter], sum);
+    }
+    return ret;
+}
+
+void counters_reset(){
+    counter_registry &reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (uint8_t counter=0; counter<counter_amount; counter++){
+        reg.finished[counter] = 0;
+        for (ThreadCounters *thread: reg.threads)
+            thread->values[counter].store(0, std::memory_order_relaxed);
+    }
+}
+
+void counters_dump(std::ostream &out){
+    if (!counters_enabled()){
+        out << "counters disabled (compile with SFL_COUNTERS)" << std::endl;
+        return;
+    }
+    for (const auto &counter: counters_snapshot())
+        out << counter.first << ": " << counter.second << std::endl;
+}
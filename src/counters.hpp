@@ -0,0 +1,100 @@
+/*! \file counters.hpp
+    \author Alexander Kaftan
+    \brief Instrumentation counters of hot paths
+*/
+
+#ifndef spacefcounters
+#define spacefcounters
+
+#include "commondefinitions.h"
+#include <atomic>
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+
+//! counted events
+/*! \enum sfl_counter
+*/
+typedef enum{
+    counter_rank=0, // RSBitmap::rank
+    counter_select, // RSBitmap::select
+    counter_next_one, // RSBitmap::next_one
+    counter_init_slate, // RSBitmap slate initializations
+    counter_make_static, // RSBitmap::make_static with rank9sel construction
+    counter_array_init, // ConstTimeArray position initializations
+    counter_get_pos, // SegmentedArray::get_pos
+    counter_stack_drop, // SpinStack::drop_front calls which dropped entries
+    counter_stack_dropped, // entries dropped by SpinStack::drop_front
+    counter_dfs_restore, // dfs_restore calls
+    counter_dfs_restore_pops, // entries processed by dfs_restore
+    counter_amount // amount of counters, no counter
+} sfl_counter;
+
+//! counters of a thread
+/*! \struct ThreadCounters
+    Registers itself for counters_snapshot, values of finished threads are kept.
+    Only the owning thread writes, so relaxed load and store are sufficient.
+*/
+struct ThreadCounters{
+    //! counter values
+    std::atomic<uint64_t> values[counter_amount];
+    //! Constructor, registers counters
+    ThreadCounters();
+    //! Destructor, keeps values
+    ~ThreadCounters();
+    ThreadCounters(const ThreadCounters&) = delete;
+    //! increase counter
+    /*! \param counter counter
+        \param amount amount to add
+    */
+    inline void add(const sfl_counter counter, const uint64_t amount) noexcept{
+        values[counter].store(values[counter].load(std::memory_order_relaxed)+amount, std::memory_order_relaxed);
+    }
+};
+
+//! counters of the current thread
+/*! \return ThreadCounters of the current thread
+*/
+inline ThreadCounters &thread_counters(){
+    static thread_local ThreadCounters counters;
+    return counters;
+}
+
+#ifdef SFL_COUNTERS
+//! count event (disabled without SFL_COUNTERS)
+#define SFL_COUNT(counter) thread_counters().add(counter, 1);
+//! count amount of events (disabled without SFL_COUNTERS)
+#define SFL_COUNT_N(counter, amount) thread_counters().add(counter, amount);
+#else
+#define SFL_COUNT(counter)
+#define SFL_COUNT_N(counter, amount)
+#endif
+
+//! are counters compiled in
+/*! \return true if compiled with SFL_COUNTERS
+*/
+bool counters_enabled() noexcept;
+
+//! name of counter
+/*! \param counter counter
+    \return name
+*/
+const char *counter_name(const sfl_counter counter) noexcept;
+
+//! sum of all counters over all threads
+/*! \return counter names with values
+*/
+std::vector<std::pair<std::string, uint64_t>> counters_snapshot();
+
+//! set all counters of all threads to 0
+/*! \warning counts of concurrently running threads may get lost
+*/
+void counters_reset();
+
+//! write all counters as text, one counter per line
+/*! \param out output stream
+*/
+void counters_dump(std::ostream &out);
+
+#endif
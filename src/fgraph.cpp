@@ -1,5 +1,8 @@
 #include "fgraph.hpp"
 #include <iostream>
+#include <random>
+#include <cmath>
+#include <unordered_map>
 
 SFL_ID_SIZE SFLGraph::n() const{
     return nodes.size();
@@ -15,14 +18,385 @@ SFL_ID_SIZE SFLGraph::head(SFL_ID_SIZE nodeid, SFL_POS_SIZE edge_position) const
     return std::get<0>(nodes[nodeid-1].edges[edge_position-1]);
 }
 
-sfl_node &SFLGraph::node(SFL_ID_SIZE nodeid){
+SpaceReport SFLGraph::space_report() const{
+    SpaceReport report;
+    uint64_t edges=0;
+    report.add("nodes", nodes.capacity()*sizeof(sfl_node));
+    for (const auto &cur_node: nodes)
+        edges += cur_node.edges.capacity()*sizeof(AdjEntry);
+    report.add("edges", edges);
+    report.add("degrees", degree_counts.capacity()*sizeof(SFL_ID_SIZE));
+    return report;
+}
+
+const sfl_node &SFLGraph::node(SFL_ID_SIZE nodeid) const{
     SFLCHECK (nodeid > 0 && nodeid <= n())
     return nodes[nodeid-1];
 }
 
+SFL_POS_SIZE SFLGraph::find_edge(SFL_ID_SIZE node1, SFL_ID_SIZE node2) const{
+    const SFL_POS_SIZE degree = deg(node1);
+    for (SFL_POS_SIZE edge=1; edge<=degree; edge++){
+        if (std::get<0>(nodes[node1-1].edges[edge-1])==node2)
+            return edge;
+    }
+    return 0;
+}
+
+SFL_ID_SIZE SFLGraph::add_node(){
+    nodes.emplace_back();
+    degree_counts[0]++;
+    return n();
+}
+
+SFL_POS_SIZE SFLGraph::add_edge(SFL_ID_SIZE node1, SFL_ID_SIZE node2){
+    SFLCHECK(node1!=0 && node2!=0)
+    SFLCHECK(node1!=node2)
+    SFLCHECK(node1<=n() && node2<=n())
+    _add_edge(node1, node2);
+    return deg(node1);
+}
+
+// remove the half edge, the last edge of the node takes its position
+static void _remove_half_edge(std::vector<sfl_node> &nodes, SFL_ID_SIZE nodeid, SFL_POS_SIZE edge_position){
+    AdjArray &edges = nodes[nodeid-1].edges;
+    if (edge_position<edges.size()){
+        edges[edge_position-1] = edges.back();
+        // backlink of the moved edge
+        const AdjEntry &moved = edges[edge_position-1];
+        std::get<1>(nodes[std::get<0>(moved)-1].edges[std::get<1>(moved)-1]) = edge_position;
+    }
+    edges.pop_back();
+}
+
+void SFLGraph::remove_edge(SFL_ID_SIZE nodeid, SFL_POS_SIZE edge_position){
+    SFLCHECK(edge_position>0 && edge_position<=deg(nodeid))
+    // the backlink fixup of the first removal keeps the mate valid
+    const AdjEntry mate_ = nodes[nodeid-1].edges[edge_position-1];
+    _remove_half_edge(nodes, nodeid, edge_position);
+    _remove_half_edge(nodes, std::get<0>(mate_), std::get<1>(mate_));
+    _change_degree(deg(nodeid)+1, deg(nodeid));
+    _change_degree(deg(std::get<0>(mate_))+1, deg(std::get<0>(mate_)));
+}
+
+void SFLGraph::apply(const std::vector<edge_update> &updates){
+    std::unordered_map<SFL_ID_SIZE, SFL_POS_SIZE> inserted;
+    for (const edge_update &update: updates){
+        SFLCHECK(update.node1!=0 && update.node2!=0)
+        SFLCHECK(update.node1<=n() && update.node2<=n())
+        if (!update.remove){
+            SFLCHECK(update.node1!=update.node2)
+            inserted[update.node1]++;
+            inserted[update.node2]++;
+        }
+    }
+    for (const auto &entry: inserted)
+        nodes[entry.first-1].edges.reserve(deg(entry.first)+entry.second);
+    SFL_POS_SIZE edge;
+    for (const edge_update &update: updates){
+        if (update.remove){
+            // scan the smaller array
+            if (deg(update.node1)<=deg(update.node2)){
+                edge = find_edge(update.node1, update.node2);
+                SFLCHECK(edge!=0)
+                remove_edge(update.node1, edge);
+            } else {
+                edge = find_edge(update.node2, update.node1);
+                SFLCHECK(edge!=0)
+                remove_edge(update.node2, edge);
+            }
+        } else {
+            _add_edge(update.node1, update.node2);
+        }
+    }
+}
+
 AdjEntry SFLGraph::mate(SFL_ID_SIZE nodeid, SFL_POS_SIZE edge_position) const{
     // Mate: input: node, position, output: reverse node, own position
     if (nodeid == 0 || nodeid > n() || edge_position==0 || edge_position > nodes[nodeid-1].edges.size())
         return AdjEntry(0,0);
     return nodes[nodeid-1].edges[edge_position-1];
 }
+
+SFLGraph SFLGraph::create_relabeled(const SFLGraph &in, const BitPackedArray &new_ids){
+    SFLCHECK(new_ids.n()==in.n())
+    SFLGraph temp(in.n());
+    RSBitmap seen(in.n());
+    SFL_ID_SIZE new_node, next_node;
+    SFL_POS_SIZE back_edge;
+    for (SFL_ID_SIZE node=1; node<=in.n(); node++){
+        new_node = new_ids.get(node);
+        // must be a permutation
+        SFLCHECK(new_node!=0 && new_node<=in.n() && !seen.get(new_node))
+        seen.set(new_node, true);
+        AdjArray &edges = temp.nodes[new_node-1].edges;
+        edges.reserve(in.deg(node));
+        for (SFL_POS_SIZE edge=1; edge<=in.deg(node); edge++){
+            std::tie(next_node, back_edge) = in.mate(node, edge);
+            edges.push_back(AdjEntry(new_ids.get(next_node), back_edge));
+        }
+    }
+    temp.degree_counts = in.degree_counts;
+    return temp;
+}
+
+SFLGraph SFLGraph::create_erdos_renyi(const SFL_ID_SIZE num_nodes, const double probability, const uint64_t seed){
+    SFLCHECK(probability>=0 && probability<=1)
+    SFLGraph temp(num_nodes);
+    if (probability==0 || num_nodes<2)
+        return temp;
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    const double log_q = std::log(1.0-probability);
+    // Batagelj and Brandes: skip over the lower triangle, 0-based
+    uint64_t node=1;
+    int64_t other=-1;
+    while (node<num_nodes){
+        if (probability==1)
+            other++;
+        else
+            other += 1+static_cast<int64_t>(std::floor(std::log(1.0-dist(gen))/log_q));
+        while (other>=static_cast<int64_t>(node) && node<num_nodes){
+            other -= node;
+            node++;
+        }
+        if (node<num_nodes)
+            temp._add_edge(node+1, other+1);
+    }
+    return temp;
+}
+
+SFLGraph SFLGraph::create_rmat(const uint8_t scale, const uint64_t edge_factor, const uint64_t seed,
+    const double a, const double b, const double c){
+    SFLCHECK(scale>0 && scale<=32)
+    SFLCHECK(a>=0 && b>=0 && c>=0 && a+b+c<=1)
+    const uint64_t num_nodes = UINT64_C(1)<<scale;
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    // both 0-based nodes in one word, smaller one first
+    std::vector<uint64_t> packed_edges;
+    packed_edges.reserve(num_nodes*edge_factor);
+    for (uint64_t counter=0; counter<num_nodes*edge_factor; counter++){
+        uint64_t node1=0, node2=0;
+        for (uint8_t bit=0; bit<scale; bit++){
+            double quadrant = dist(gen);
+            if (quadrant<a){
+            } else if (quadrant<a+b){
+                node2 |= UINT64_C(1)<<bit;
+            } else if (quadrant<a+b+c){
+                node1 |= UINT64_C(1)<<bit;
+            } else {
+                node1 |= UINT64_C(1)<<bit;
+                node2 |= UINT64_C(1)<<bit;
+            }
+        }
+        if (node1==node2)
+            continue;
+        if (node1>node2)
+            std::swap(node1, node2);
+        packed_edges.push_back((node1<<32)|node2);
+    }
+    std::sort(packed_edges.begin(), packed_edges.end());
+    packed_edges.erase(std::unique(packed_edges.begin(), packed_edges.end()), packed_edges.end());
+    SFLGraph temp(num_nodes);
+    for (uint64_t edge: packed_edges)
+        temp._add_edge((edge>>32)+1, (edge&UINT32_MAX)+1);
+    return temp;
+}
+
+SFLGraph SFLGraph::create_geometric(const SFL_ID_SIZE num_nodes, const double radius, const uint64_t seed){
+    SFLCHECK(radius>0)
+    SFLGraph temp(num_nodes);
+    if (num_nodes<2)
+        return temp;
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    // grid cells of size radius, only neighboring cells can contain neighbors
+    const uint64_t cells_per_row = std::max<uint64_t>(1, std::min<uint64_t>(std::floor(1.0/radius), std::ceil(std::sqrt(num_nodes))));
+    const double cell_size = 1.0/cells_per_row;
+    std::vector<std::pair<double, double>> points(num_nodes);
+    std::vector<uint64_t> cell_start(cells_per_row*cells_per_row+1, 0);
+    auto cell_of = [&cells_per_row, &cell_size](const std::pair<double, double> &point){
+        uint64_t column = std::min<uint64_t>(point.first/cell_size, cells_per_row-1);
+        uint64_t row = std::min<uint64_t>(point.second/cell_size, cells_per_row-1);
+        return row*cells_per_row+column;
+    };
+    for (auto &point: points){
+        point.first = dist(gen);
+        point.second = dist(gen);
+        cell_start[cell_of(point)+1]++;
+    }
+    // counting sort by cell, node id = position in sorted order
+    for (uint64_t cell=1; cell<cell_start.size(); cell++)
+        cell_start[cell] += cell_start[cell-1];
+    std::vector<std::pair<double, double>> sorted(num_nodes);
+    {
+        std::vector<uint64_t> fill(cell_start.begin(), cell_start.end()-1);
+        for (const auto &point: points)
+            sorted[fill[cell_of(point)]++] = point;
+    }
+    points.clear();
+    points.shrink_to_fit();
+    const double radius2 = radius*radius;
+    for (uint64_t node=0; node<num_nodes; node++){
+        const uint64_t cell = cell_of(sorted[node]);
+        const int64_t row = cell/cells_per_row, column = cell%cells_per_row;
+        for (int64_t next_row=std::max<int64_t>(row-1, 0); next_row<=std::min<int64_t>(row+1, cells_per_row-1); next_row++){
+            for (int64_t next_column=std::max<int64_t>(column-1, 0); next_column<=std::min<int64_t>(column+1, cells_per_row-1); next_column++){
+                const uint64_t next_cell = next_row*cells_per_row+next_column;
+                // every pair once: only higher nodes
+                for (uint64_t next_node=std::max(cell_start[next_cell], node+1); next_node<cell_start[next_cell+1]; next_node++){
+                    const double dx = sorted[node].first-sorted[next_node].first;
+                    const double dy = sorted[node].second-sorted[next_node].second;
+                    if (dx*dx+dy*dy<=radius2)
+                        temp._add_edge(node+1, next_node+1);
+                }
+            }
+        }
+    }
+    return temp;
+}
+
+SFLGraph SFLGraph::create_path(const SFL_ID_SIZE num_nodes){
+    SFLGraph temp(num_nodes);
+    for (SFL_ID_SIZE node=1; node<num_nodes; node++)
+        temp._add_edge(node, node+1);
+    return temp;
+}
+
+SFLGraph SFLGraph::create_cycle(const SFL_ID_SIZE num_nodes){
+    SFLCHECK(num_nodes>=3)
+    SFLGraph temp = create_path(num_nodes);
+    temp._add_edge(num_nodes, 1);
+    return temp;
+}
+
+SFLGraph SFLGraph::create_star(const SFL_ID_SIZE num_nodes){
+    SFLGraph temp(num_nodes);
+    for (SFL_ID_SIZE node=2; node<=num_nodes; node++)
+        temp._add_edge(1, node);
+    return temp;
+}
+
+SFLGraph SFLGraph::create_clique_chain(const SFL_ID_SIZE cliques, const SFL_ID_SIZE clique_size){
+    SFLCHECK(clique_size>=2)
+    if (cliques==0)
+        return SFLGraph(0);
+    SFLGraph temp(cliques*(clique_size-1)+1);
+    for (SFL_ID_SIZE clique=0; clique<cliques; clique++){
+        // first node is shared with the previous clique
+        const SFL_ID_SIZE first = clique*(clique_size-1)+1;
+        for (SFL_ID_SIZE node1=first; node1<first+clique_size; node1++){
+            for (SFL_ID_SIZE node2=node1+1; node2<first+clique_size; node2++)
+                temp._add_edge(node1, node2);
+        }
+    }
+    return temp;
+}
+
+SFLGraph SFLGraph::create_grid(const SFL_ID_SIZE rows, const SFL_ID_SIZE columns){
+    SFLGraph temp(rows*columns);
+    for (SFL_ID_SIZE row=1; row<=rows; row++){
+        for (SFL_ID_SIZE column=1; column<=columns; column++){
+            const SFL_ID_SIZE node = (row-1)*columns+column;
+            if (column<columns)
+                temp._add_edge(node, node+1);
+            if (row<rows)
+                temp._add_edge(node, node+columns);
+        }
+    }
+    return temp;
+}
+
+// nodes by degree (counting sort), stable
+static void _sort_by_degree(const SFLGraph &graph, BitPackedArray &sorted, const bool descending){
+    const SFL_POS_SIZE max_degree = graph.max_deg();
+    std::vector<SFL_ID_SIZE> starts(max_degree+2, 0);
+    SFL_POS_SIZE key;
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        key = descending ? max_degree-graph.deg(node) : graph.deg(node);
+        starts[key+1]++;
+    }
+    for (SFL_POS_SIZE degree=1; degree<starts.size(); degree++)
+        starts[degree] += starts[degree-1];
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        key = descending ? max_degree-graph.deg(node) : graph.deg(node);
+        sorted.set(++starts[key], node);
+    }
+}
+
+BitPackedArray node_order(const SFLGraph &graph, const relabel_order order){
+    const SFL_ID_SIZE n = graph.n();
+    BitPackedArray new_ids(n, BitPackedArray::calc_width(n));
+    // nodes in the new order, used as queue of the breadth-first-search
+    BitPackedArray sequence(n, BitPackedArray::calc_width(n));
+    if (order==relabel_degree){
+        _sort_by_degree(graph, sequence, true);
+        for (SFL_ID_SIZE pos=1; pos<=n; pos++)
+            new_ids.set(sequence.get(pos), pos);
+        return new_ids;
+    }
+    SFLCHECK(order==relabel_bfs || order==relabel_rcm)
+    // start candidates
+    BitPackedArray starts(order==relabel_rcm ? n : 0, BitPackedArray::calc_width(n));
+    if (order==relabel_rcm)
+        _sort_by_degree(graph, starts, false);
+    std::vector<SFL_ID_SIZE> neighbors;
+    SFL_ID_SIZE start, node, next_node, tail=0;
+    for (SFL_ID_SIZE pos=1; pos<=n; pos++){
+        start = order==relabel_rcm ? starts.get(pos) : pos;
+        if (new_ids.get(start)!=0)
+            continue;
+        new_ids.set(start, ++tail);
+        sequence.set(tail, start);
+        for (SFL_ID_SIZE head_pos=tail; head_pos<=tail; head_pos++){
+            node = sequence.get(head_pos);
+            neighbors.clear();
+            for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                next_node = graph.head(node, edge);
+                if (new_ids.get(next_node)==0){
+                    // mark as enqueued
+                    new_ids.set(next_node, 1);
+                    neighbors.push_back(next_node);
+                }
+            }
+            if (order==relabel_rcm){
+                std::stable_sort(neighbors.begin(), neighbors.end(), [&graph](SFL_ID_SIZE node1, SFL_ID_SIZE node2){
+                    return graph.deg(node1)<graph.deg(node2);
+                });
+            }
+            for (SFL_ID_SIZE neighbor: neighbors){
+                new_ids.set(neighbor, ++tail);
+                sequence.set(tail, neighbor);
+            }
+        }
+    }
+    assert(tail==n);
+    if (order==relabel_rcm){
+        for (SFL_ID_SIZE pos=1; pos<=n; pos++)
+            new_ids.set(sequence.get(pos), n+1-pos);
+    }
+    return new_ids;
+}
+
+RelabeledGraph::RelabeledGraph(const SFLGraph &graph, BitPackedArray &&new_ids_):
+new_ids(std::move(new_ids_)), old_ids(graph.n(), BitPackedArray::calc_width(graph.n())),
+graph_(SFLGraph::create_relabeled(graph, new_ids)){
+    // create_relabeled checked the permutation
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++)
+        old_ids.set(new_ids.get(node), node);
+}
+
+const RSBitmap RelabeledGraph::map_back(const RSBitmap &bitmap) const{
+    RSBitmap ret(bitmap.n());
+    for (SFL_ID_SIZE node=1; node<=bitmap.n(); node++){
+        if (bitmap.get(node))
+            ret.set(old_ids.get(node), true);
+    }
+    ret.make_static();
+    return ret;
+}
+
+RelabeledGraph relabel(const SFLGraph &graph, const relabel_order order){
+    return RelabeledGraph(graph, node_order(graph, order));
+}
@@ -8,6 +8,7 @@
 // c++ stuff
 
 #include "commondefinitions.h"
+#include "misc.hpp"
 #include <vector>
 #include <algorithm>
 #include <istream>
@@ -44,6 +45,18 @@ struct sfl_node{
     sfl_node(){}
 };
 
+//! single edge update for SFLGraph::apply
+/*! \struct edge_update
+*/
+struct edge_update{
+    //! first node
+    SFL_ID_SIZE node1;
+    //! second node
+    SFL_ID_SIZE node2;
+    //! remove an edge between node1 and node2 instead of inserting one
+    bool remove;
+};
+
 //! iterator for nodes in adjacence array of SFLGraph
 /*! \typedef node_iterator
 */
@@ -82,11 +95,48 @@ class SFLGraph{
 protected:
     //! adjacence array
     std::vector<sfl_node> nodes;
+    //! amount of nodes per degree, the last entry is the maximal degree (never 0 except for empty graphs)
+    std::vector<SFL_ID_SIZE> degree_counts;
     //! initialize graph with number of nodes, needs further initialisation
     /*!
         \param num_nodes number of nodes to initialize with
     */
-    SFLGraph(SFL_ID_SIZE num_nodes) : nodes(num_nodes) {}
+    SFLGraph(SFL_ID_SIZE num_nodes) : nodes(num_nodes), degree_counts(1, num_nodes) {}
+    //! recount degree_counts, required after filling nodes directly
+    void _count_degrees(){
+        degree_counts.assign(1, 0);
+        for (const sfl_node &cur_node: nodes){
+            if (cur_node.edges.size()>=degree_counts.size())
+                degree_counts.resize(cur_node.edges.size()+1, 0);
+            degree_counts[cur_node.edges.size()]++;
+        }
+    }
+    //! update degree_counts after the degree of a node changed
+    /*!
+        \param old_degree degree before the change
+        \param new_degree degree after the change
+    */
+    void _change_degree(const SFL_POS_SIZE old_degree, const SFL_POS_SIZE new_degree){
+        degree_counts[old_degree]--;
+        if (new_degree>=degree_counts.size())
+            degree_counts.resize(new_degree+1, 0);
+        degree_counts[new_degree]++;
+        while (degree_counts.size()>1 && degree_counts.back()==0)
+            degree_counts.pop_back();
+    }
+    //! add undirected edge with mates
+    /*!
+        \param node1 first node
+        \param node2 second node
+    */
+    void _add_edge(const SFL_ID_SIZE node1, const SFL_ID_SIZE node2){
+        SFL_POS_SIZE position1 = nodes[node1-1].edges.size()+1;
+        SFL_POS_SIZE position2 = nodes[node2-1].edges.size()+1;
+        nodes[node1-1].edges.push_back(AdjEntry(node2, position2));
+        nodes[node2-1].edges.push_back(AdjEntry(node1, position1));
+        _change_degree(position1-1, position1);
+        _change_degree(position2-1, position2);
+    }
 public:
     //! disable copy constructor
     SFLGraph(const SFLGraph& other) = delete;
@@ -124,6 +174,7 @@ public:
             temp.nodes[current_node-1].edges.push_back(AdjEntry(next_node, counter_position));
             temp.nodes[next_node-1].edges.push_back(AdjEntry(current_node, current_position));
         }
+        temp._count_degrees();
         return temp;
     }
     //! Constructs graph from adjacence list file
@@ -194,6 +245,7 @@ public:
                     break;
             }
         }
+        temp._count_degrees();
         return temp;
     }
 
@@ -210,9 +262,75 @@ public:
                 temp.nodes[current_node-1].edges.push_back(in.mate(current_node, current_edge));
             }
         }
+        temp.degree_counts = in.degree_counts;
         return temp;
     }
+    //! Copy SFLGraph with other node ids
+    /*! \param in SFLGraph to copy
+        \param new_ids permutation with the new id of every node of in
+        \return SFLGraph where node new_ids.get(node) has the edges of node
+        Keeps the order of every adjacency array, so edge positions and backlinks stay the same.
+    */
+    static SFLGraph create_relabeled(const SFLGraph &in, const BitPackedArray &new_ids);
+
 
+    //! Generate Erdős–Rényi graph G(n,p)
+    /*! \param num_nodes amount of nodes
+        \param probability probability of every edge
+        \param seed seed of the random generator
+        \return SFLGraph
+        Uses geometric skipping, so the runtime is linear in nodes+edges.
+    */
+    static SFLGraph create_erdos_renyi(const SFL_ID_SIZE num_nodes, const double probability, const uint64_t seed=1);
+    //! Generate R-MAT (Kronecker) graph
+    /*! \param scale graph has 2^scale nodes (max 32)
+        \param edge_factor edges per node which are generated, loops and duplicates are removed afterwards
+        \param seed seed of the random generator
+        \param a probability of upper left quadrant
+        \param b probability of upper right quadrant
+        \param c probability of lower left quadrant
+        \return SFLGraph
+        Defaults are the Graph500 parameters.
+    */
+    static SFLGraph create_rmat(const uint8_t scale, const uint64_t edge_factor, const uint64_t seed=1,
+        const double a=0.57, const double b=0.19, const double c=0.19);
+    //! Generate random geometric graph
+    /*! \param num_nodes amount of nodes, uniform in the unit square
+        \param radius nodes with at most this distance are connected
+        \param seed seed of the random generator
+        \return SFLGraph
+        Uses a grid with cell size radius, nodes are numbered by cell.
+    */
+    static SFLGraph create_geometric(const SFL_ID_SIZE num_nodes, const double radius, const uint64_t seed=1);
+    //! Generate path 1-2-...-n
+    /*! \param num_nodes amount of nodes
+        \return SFLGraph
+    */
+    static SFLGraph create_path(const SFL_ID_SIZE num_nodes);
+    //! Generate cycle 1-2-...-n-1
+    /*! \param num_nodes amount of nodes (at least 3)
+        \return SFLGraph
+    */
+    static SFLGraph create_cycle(const SFL_ID_SIZE num_nodes);
+    //! Generate star with center 1
+    /*! \param num_nodes amount of nodes
+        \return SFLGraph
+    */
+    static SFLGraph create_star(const SFL_ID_SIZE num_nodes);
+    //! Generate chain of cliques
+    /*! \param cliques amount of cliques
+        \param clique_size nodes per clique (at least 2)
+        \return SFLGraph
+        Consecutive cliques share one node, so there are cliques-1 cutvertices.
+    */
+    static SFLGraph create_clique_chain(const SFL_ID_SIZE cliques, const SFL_ID_SIZE clique_size);
+    //! Generate grid
+    /*! \param rows amount of rows
+        \param columns amount of columns
+        \return SFLGraph
+        Node (row, column) has the id (row-1)*columns+column.
+    */
+    static SFLGraph create_grid(const SFL_ID_SIZE rows, const SFL_ID_SIZE columns);
 
 #ifdef USE_BOOST
     //! Constructs graph from dot file
@@ -259,6 +377,7 @@ public:
             temp.nodes[current_node-1].edges.push_back(AdjEntry(next_node, counter_position));
             temp.nodes[next_node-1].edges.push_back(AdjEntry(current_node, current_position));
         }
+        temp._count_degrees();
         return temp;
     }
 #endif
@@ -284,8 +403,61 @@ public:
         \return mate operation
     */
     virtual AdjEntry mate(SFL_ID_SIZE nodeid, SFL_POS_SIZE edge_position) const;
+    //! maximal degree
+    /*! \return maximal degree of all nodes (0 for empty graphs)
+        Constant time, the amount of nodes per degree is kept up to date by all updates.
+    */
+    inline SFL_POS_SIZE max_deg() const noexcept{
+        return degree_counts.size()-1;
+    }
+    //! used memory by component
+    /*! \return SpaceReport with node array and adjacency arrays
+    */
+    SpaceReport space_report() const;
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
     //! get node to nodeid
-    sfl_node &node(SFL_ID_SIZE nodeid);
+    /*! read only, use add_edge/remove_edge to change the adjacency arrays
+    */
+    const sfl_node &node(SFL_ID_SIZE nodeid) const;
+    //! position of an edge
+    /*! \param node1 first node
+        \param node2 second node
+        \return position of the first edge to node2 in the array of node1, 0 if there is none
+        Scans the adjacency array of node1.
+    */
+    SFL_POS_SIZE find_edge(SFL_ID_SIZE node1, SFL_ID_SIZE node2) const;
+    //! append isolated node
+    /*! \return id of the new node (= n())
+    */
+    SFL_ID_SIZE add_node();
+    //! insert undirected edge
+    /*! \param node1 first node
+        \param node2 second node
+        \return position of the new edge in the array of node1
+        Amortized O(1), the edge is appended to both arrays.
+        Multi edges are not detected, the algorithms expect a simple graph.
+        Structures derived from the graph (annotations, cutvertices, ...) are invalidated.
+    */
+    SFL_POS_SIZE add_edge(SFL_ID_SIZE node1, SFL_ID_SIZE node2);
+    //! remove undirected edge
+    /*! \param nodeid id of node
+        \param edge_position edge position
+        O(1), the last edges of both endpoints take the freed positions and
+        the backlinks to them are updated. So positions of other edges change.
+        Structures derived from the graph (annotations, cutvertices, ...) are invalidated.
+    */
+    void remove_edge(SFL_ID_SIZE nodeid, SFL_POS_SIZE edge_position);
+    //! apply batch of edge updates
+    /*! \param updates updates, applied in order
+        Reserves the space of all insertions at once. Removals use find_edge and
+        fail if there is no such edge, updates before the failing one stay applied.
+    */
+    void apply(const std::vector<edge_update> &updates);
 
     //! iterator to begin of nodes
     /*! iterator return degrees of node
@@ -302,5 +474,101 @@ public:
     }
 };
 
+//! node orders for relabel
+/*! \enum relabel_order
+    relabel_bfs: breadth-first-search from the lowest unvisited node
+    relabel_rcm: reverse Cuthill-McKee, breadth-first-search from a node of minimal degree with neighbors by ascending degree
+    relabel_degree: descending degree
+*/
+typedef enum{
+    relabel_bfs=0,
+    relabel_rcm=1,
+    relabel_degree=2
+} relabel_order;
+
+//! new node ids for a better locality
+/*! \param graph Graph object
+    \param order relabel_order
+    \return BitPackedArray with the new id of every node (a permutation)
+    All orders are stable (ties keep the order of the ids) and take O(n+m) time, relabel_rcm O(m log(max_deg)).
+*/
+BitPackedArray node_order(const SFLGraph &graph, const relabel_order order=relabel_rcm);
+
+//! Graph with permuted node ids
+/*! \class RelabeledGraph
+    Holds the permuted graph (see SFLGraph::create_relabeled) and the permutation and its inverse
+    as BitPackedArrays with ceil(log2(n+1)) bits per entry. Edge positions are the same in both graphs.
+    The overloads of cutvertices and biconnected_components for RelabeledGraph run on the permuted graph
+    and return original ids.
+*/
+class RelabeledGraph{
+    //! new id of every original node
+    BitPackedArray new_ids;
+    //! original id of every new node
+    BitPackedArray old_ids;
+    //! permuted graph
+    SFLGraph graph_;
+public:
+    //! Constructor
+    /*! \param graph Graph object
+        \param new_ids_ new id of every node, must be a permutation
+    */
+    RelabeledGraph(const SFLGraph &graph, BitPackedArray &&new_ids_);
+    //! disable copy constructor
+    RelabeledGraph(const RelabeledGraph&) = delete;
+    //! Move Constructor
+    RelabeledGraph(RelabeledGraph&&) = default;
+    //! Move assignment
+    RelabeledGraph& operator=(RelabeledGraph&&) = default;
+    //! permuted graph
+    /*! \return SFLGraph with the new ids
+    */
+    inline const SFLGraph &graph() const noexcept{
+        return graph_;
+    }
+    //! new id
+    /*! \param node original id
+        \return new id (0 for invalid nodes)
+    */
+    inline SFL_ID_SIZE new_id(const SFL_ID_SIZE node) const{
+        return new_ids.get(node);
+    }
+    //! original id
+    /*! \param node new id
+        \return original id (0 for invalid nodes)
+    */
+    inline SFL_ID_SIZE old_id(const SFL_ID_SIZE node) const{
+        return old_ids.get(node);
+    }
+    //! map node bitmap back
+    /*! \param bitmap RSBitmap indexed by new ids
+        \return static RSBitmap indexed by original ids
+    */
+    const RSBitmap map_back(const RSBitmap &bitmap) const;
+    //! used memory by component
+    /*! \return SpaceReport with permutations and graph
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        report.add("new_ids", new_ids.space_report());
+        report.add("old_ids", old_ids.space_report());
+        report.add("graph", graph_.space_report());
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
+};
+
+//! relabel graph
+/*! \param graph Graph object
+    \param order relabel_order
+    \return RelabeledGraph
+*/
+RelabeledGraph relabel(const SFLGraph &graph, const relabel_order order=relabel_rcm);
+
 
 #endif
@@ -2,22 +2,30 @@
 #include "graph.hpp"
 #include <cmath>
 #include <optional>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
 using namespace std;
 
 bool dfs_placeholder(...){
     return true;
 }
 
-void dfs_restore(const SFL_ID_SIZE vertex, const SFLGraph &graph, SpinStack<AdjEntry> &Stack, RSBitmap &color, SFL_ID_SIZE restore, bool restore_step, const uint64_t q){
+// returns if entries were dropped, the stack holds the full path otherwise
+template<class Stack_t>
+bool dfs_restore(const SFL_ID_SIZE vertex, const SFLGraph &graph, Stack_t &Stack, RSBitmap &color, SFL_ID_SIZE restore, bool restore_step, const uint64_t q){
     SFL_ID_SIZE cur_node, next_node, parent=0;
+    bool truncated=false;
     SFL_POS_SIZE cur_edge;
     SFL_POS_SIZE cached_deg;
     // for debug, use in asserts
     SFL_ID_SIZE graph_n = graph.n();
     assert (vertex > 0 && vertex <= graph_n);
+    SFL_COUNT(counter_dfs_restore)
     Stack.push_top(AdjEntry(vertex, 1));
     while(!Stack.empty()){
         AdjEntry tup_current = Stack.pop();
+        SFL_COUNT(counter_dfs_restore_pops)
         std::tie(cur_node, cur_edge) = tup_current;
         cached_deg = graph.deg(cur_node);
         // restore_step 0
@@ -42,7 +50,7 @@ void dfs_restore(const SFL_ID_SIZE vertex, const SFLGraph &graph, SpinStack<AdjE
             assert(next_node > 0);
             assert(next_node<=graph_n);
             if (next_node==restore)
-                return;
+                return truncated;
             // ignore parents for the cost of one extra Stack element
             // requires always 1 parent on the stack if not root
             if (parent!=next_node){
@@ -53,17 +61,20 @@ void dfs_restore(const SFL_ID_SIZE vertex, const SFLGraph &graph, SpinStack<AdjE
                 }
             }
         } else {
-            return;
+            return truncated;
         }
         // +1 for having always a parent
         if (Stack.size()>2*q+1){
             Stack.drop_front(q);
+            truncated=true;
         }
     }
+    return truncated;
 }
 
 
-void dfs_base(const SFL_ID_SIZE vertex, const SFLGraph &graph, SpinStack<AdjEntry> &Stack, RSBitmap &color, bool restore_step, const uint64_t q,
+template<class Stack_t>
+void dfs_base(const SFL_ID_SIZE vertex, const SFLGraph &graph, Stack_t &Stack, RSBitmap &color, bool restore_step, const uint64_t q,
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore,
     const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore,
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess,
@@ -76,6 +87,8 @@ void dfs_base(const SFL_ID_SIZE vertex, const SFLGraph &graph, SpinStack<AdjEntr
     assert(vertex > 0 && vertex <= graph_n);
     Stack.push_top(AdjEntry(vertex, 1));
     bool firstrun=true;
+    // restore is only required if parts of the path were dropped
+    bool truncated=false;
     while(!Stack.empty()){
         AdjEntry tup_current = Stack.pop();
         // second case postexplore is called, needs current information
@@ -128,13 +141,13 @@ void dfs_base(const SFL_ID_SIZE vertex, const SFLGraph &graph, SpinStack<AdjEntr
             color.set_n(cur_node, 2, black);
             // stack never runs empty if node doesn't turn black (always+1)
             // reserve+1 for having always a parent
-            if (Stack.size() <= 1 && color.get_n(vertex, 2) != black) {
+            if (truncated && Stack.size() <= 1 && color.get_n(vertex, 2) != black) {
                 // clean stack (always parent)
                 if (!Stack.empty())
                     Stack.pop();
                 // restore process should use different gray and the color should switch for the main routine
                 restore_step = !restore_step;
-                dfs_restore(vertex, graph, Stack, color, cur_node, restore_step, q);
+                truncated = dfs_restore(vertex, graph, Stack, color, cur_node, restore_step, q);
             }
             postprocess(cur_node, cached_deg);
         }
@@ -142,6 +155,7 @@ void dfs_base(const SFL_ID_SIZE vertex, const SFLGraph &graph, SpinStack<AdjEntr
         // +1 for having always a parent
         if (Stack.size()>2*q+1){
             Stack.drop_front(q);
+            truncated=true;
         }
         firstrun=false;
     }
@@ -222,20 +236,14 @@ void dfs_base_parents(const SFL_ID_SIZE vertex, const SFLGraph &graph, std::opti
     }
 }
 
-void dfs(const SFLGraph &graph, const SFL_ID_SIZE vertex,
+// dfs over full graph or node with given stack and cleared colors
+template<class Stack_t>
+void dfs_stack(const SFLGraph &graph, const SFL_ID_SIZE vertex, Stack_t &Stack, RSBitmap &color, const uint64_t q,
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore,
     const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore,
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess,
     const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess){
-    // for speedup
     SFL_ID_SIZE graph_n = graph.n();
-    uint64_t q = graph_n/log(graph_n);
-    SFLCHECK (vertex <= graph_n);
-    // 0 is default, = white
-    // *2 for block building
-    RSBitmap color(graph_n*2);
-    // +1 for algorithm, +1 for having always a parent
-    SpinStack<AdjEntry> Stack(2+2*q);
     if (vertex == 0){
         for (SFL_ID_SIZE vcount=1; vcount<=graph_n; vcount++){
             // only white nodes
@@ -260,7 +268,90 @@ void dfs(const SFLGraph &graph, const SFL_ID_SIZE vertex,
     dfs_base(vertex, graph, Stack, color, false, q, preexplore, postexplore, preprocess, postprocess);
 }
 
+DfsWorkspace::DfsWorkspace(const SFLGraph &graph): n_(graph.n()),
+// edge positions on the stack go up to deg+1
+max_edge_(graph.max_deg()+1),
+q(graph.n()>2 ? graph.n()/log(graph.n()) : 1),
+// 0 is default, = white
+// *2 for block building
+color(graph.n()*2){
+    _create_stack();
+}
+
+void DfsWorkspace::_create_stack(){
+    packed_stack.reset();
+    stack.reset();
+    // +1 for algorithm, +1 for having always a parent
+    if (PackedSpinStack::fits(n_, max_edge_))
+        packed_stack.emplace(2+2*q, n_, max_edge_);
+    else
+        stack.emplace(2+2*q);
+}
+
+void DfsWorkspace::prepare(const SFLGraph &graph){
+    SFLCHECK (graph.n()==n_)
+    // the packed entries don't fit anymore
+    if (graph.max_deg()+1>max_edge_){
+        max_edge_ = graph.max_deg()+1;
+        if (packed_stack)
+            _create_stack();
+    }
+    clear();
+}
+
+void DfsWorkspace::clear(){
+    color.clear();
+    if (packed_stack)
+        packed_stack->clear();
+    if (stack)
+        stack->clear();
+}
+
+SpaceReport DfsWorkspace::space_report() const{
+    SpaceReport report;
+    report.add("color", color.space_report());
+    if (packed_stack)
+        report.add("stack", packed_stack->space_report());
+    if (stack)
+        report.add("stack", stack->space_report());
+    return report;
+}
+
+void dfs(const SFLGraph &graph, const SFL_ID_SIZE vertex,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore,
+    const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess,
+    const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess){
+    SFLCHECK (vertex <= graph.n());
+    DfsWorkspace workspace(graph);
+    dfs(graph, workspace, vertex, preexplore, postexplore, preprocess, postprocess);
+}
+
+void dfs(const SFLGraph &graph, DfsWorkspace &workspace, const SFL_ID_SIZE vertex,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore,
+    const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess,
+    const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess){
+    SFLCHECK (vertex <= graph.n());
+    workspace.prepare(graph);
+    if (workspace.packed_stack){
+        dfs_stack(graph, vertex, *workspace.packed_stack, workspace.color, workspace.q, preexplore, postexplore, preprocess, postprocess);
+    } else {
+        dfs_stack(graph, vertex, *workspace.stack, workspace.color, workspace.q, preexplore, postexplore, preprocess, postprocess);
+    }
+}
+
 void dfs(const SFLGraph &graph, const annotated_edges_t& annotated, const SFL_ID_SIZE vertex,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore,
+    const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess,
+    const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess){
+    SFLCHECK (vertex <= graph.n());
+    DfsWorkspace workspace(graph);
+    dfs(graph, annotated, workspace, vertex, preexplore, postexplore, preprocess, postprocess);
+}
+
+void dfs(const SFLGraph &graph, const annotated_edges_t& annotated, DfsWorkspace &workspace, const SFL_ID_SIZE vertex,
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore,
     const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore,
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess,
@@ -268,9 +359,8 @@ void dfs(const SFLGraph &graph, const annotated_edges_t& annotated, const SFL_ID
     // for speedup
     SFL_ID_SIZE graph_n = graph.n();
     SFLCHECK (vertex <= graph_n);
-    // 0 is default, = white
-    // *2 for block building
-    RSBitmap color(graph_n*2);
+    workspace.prepare(graph);
+    RSBitmap &color = workspace.color;
     // requires 1 Entry
     std::optional<AdjEntry> Element;
     if (vertex == 0){
@@ -298,6 +388,125 @@ void dfs(const SFLGraph &graph, const annotated_edges_t& annotated, const SFL_ID
 }
 
 
+DfsEvents::DfsEvents(const SFLGraph &graph, const SFL_ID_SIZE vertex): graph(graph),
+vertex(vertex),
+q(graph.n()>2 ? graph.n()/log(graph.n()) : 1),
+// 0 is default, = white
+// *2 for block building
+color(graph.n()*2),
+// +1 for algorithm, +1 for having always a parent
+Stack(2+2*q){
+    SFLCHECK (vertex <= graph.n());
+}
+
+void DfsEvents::emit(dfs_event_type type, SFL_ID_SIZE node, SFL_POS_SIZE edge, SFL_ID_SIZE next, bool is_root){
+    assert(pending_count<2);
+    dfs_event &event = pending[(pending_first+pending_count)%2];
+    event.type = type;
+    event.node = node;
+    event.edge = edge;
+    event.next = next;
+    event.is_root = is_root;
+    pending_count++;
+}
+
+bool DfsEvents::next_tree(){
+    SFL_ID_SIZE graph_n = graph.n();
+    if (vertex!=0){
+        // single search finished
+        if (cur_root!=0)
+            return false;
+        cur_root = vertex;
+    } else {
+        // only white nodes
+        while (next_root<=graph_n && color.get_n(next_root, 2)!=white)
+            next_root++;
+        if (next_root>graph_n)
+            return false;
+        cur_root = next_root++;
+    }
+    // optimize single nodes
+    if (graph.deg(cur_root)==0){
+        emit(dfs_enter, cur_root, 0, 0, true);
+        emit(dfs_leave, cur_root, 0, 0, false);
+        return true;
+    }
+    restore_step = false;
+    truncated = false;
+    Stack.push_top(AdjEntry(cur_root, 1));
+    return true;
+}
+
+bool DfsEvents::step(){
+    SFL_ID_SIZE cur_node, next_node, parent;
+    SFL_POS_SIZE cur_edge;
+    SFL_POS_SIZE cached_deg;
+    uint8_t next_color;
+    if (Stack.empty())
+        return next_tree();
+    // same steps as dfs_base
+    std::tie(cur_node, cur_edge) = Stack.pop();
+    cached_deg = graph.deg(cur_node);
+    if (color.get_n(cur_node, 2)==white)
+        emit(dfs_enter, cur_node, cached_deg, 0, cur_root==cur_node);
+    // restore_step 0
+    if (!restore_step){
+        color.set_n(cur_node, 2, gray);
+    } else {
+        // restore_step 1
+        color.set_n(cur_node, 2, darkgray);
+    }
+    if (cur_edge <= cached_deg){
+        // extract parent from stack if not root
+        if (!Stack.empty())
+            parent = std::get<0>(Stack.peek());
+        else
+            parent = 0;
+        // after extracting parent, push new edge
+        Stack.push_top(AdjEntry(cur_node, cur_edge+1));
+        next_node = graph.head(cur_node, cur_edge);
+        assert(next_node > 0);
+        // ignore parents for the cost of one extra Stack element
+        if (parent!=next_node){
+            next_color = color.get_n(next_node, 2);
+            if (next_color == white){
+                emit(dfs_tree_edge, cur_node, cur_edge, next_node, false);
+                Stack.push_top(AdjEntry(next_node, 1));
+            } else if (next_color != black){
+                emit(dfs_back_edge, cur_node, cur_edge, next_node, false);
+            }
+        }
+    } else {
+        color.set_n(cur_node, 2, black);
+        // stack never runs empty if node doesn't turn black (always+1)
+        if (truncated && Stack.size() <= 1 && color.get_n(cur_root, 2) != black) {
+            // clean stack (always parent)
+            if (!Stack.empty())
+                Stack.pop();
+            restore_step = !restore_step;
+            truncated = dfs_restore(cur_root, graph, Stack, color, cur_node, restore_step, q);
+        }
+        emit(dfs_leave, cur_node, cached_deg, 0, false);
+    }
+    // +1 for having always a parent
+    if (Stack.size()>2*q+1){
+        Stack.drop_front(q);
+        truncated = true;
+    }
+    return true;
+}
+
+bool DfsEvents::next(dfs_event &event){
+    while(pending_count==0){
+        if (!step())
+            return false;
+    }
+    event = pending[pending_first];
+    pending_first = (pending_first+1)%2;
+    pending_count--;
+    return true;
+}
+
 void mark_parents(const SFLGraph &graph, const annotated_edges_t &annotated, const parent_edges_t &parents, marked_edges_t &marks, AdjEntry entry,SFL_ID_SIZE stop_node){
     SFL_ID_SIZE parent_id;
     uint8_t last_mark;
@@ -370,9 +579,14 @@ void mark_parents(const SFLGraph &graph, const annotated_edges_t &annotated, con
 }
 
 
-void mark_edges(const SFLGraph &graph, const annotated_edges_t &annotated, marked_edges_t &marks){
-    const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
-    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> marking = [&graph, &annotated, &parents, &marks](SFL_ID_SIZE node, SFL_POS_SIZE size, bool){
+dfs_visitor mark_visitor(const SFLGraph &graph, const annotated_edges_t &annotated, marked_edges_t &marks, const RSBitmap &removednodes, const uint8_t pass){
+    dfs_visitor visitor;
+    visitor.pass = pass;
+    visitor.preprocess = [&graph, &annotated, &marks, &removednodes](SFL_ID_SIZE node, SFL_POS_SIZE size, bool){
+        const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+        // same traversal as annotate_visitor, removed nodes are neither roots nor children
+        if (removednodes.get(node))
+            return false;
         // empty nodes are not relevant
         if (size==0)
             return true;
@@ -381,70 +595,314 @@ void mark_edges(const SFLGraph &graph, const annotated_edges_t &annotated, marke
             mark_parents(graph, annotated, parents, marks, graph.mate(node, pos), node);
             pos = annotated.select_segment_pos(std::get<edges_backlink>(annotated.arrays), node, pos+1);
         }
-        // ignore if completely unmarked (can only see here)
-        if(annotated.select_segment_pos(marks, node, 1)==0)
+        // chains have to be marked in preorder, so unmarked subtrees can't be skipped
+        return true;
+    };
+    visitor.preexplore = [&removednodes](SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE next, uint8_t){
+        return !removednodes.get(next);
+    };
+    return visitor;
+}
+
+void mark_edges(const SFLGraph &graph, const annotated_edges_t &annotated, marked_edges_t &marks){
+    FusedTraversal fused;
+    fused.add(mark_visitor(graph, annotated, marks, null_bitmap, 0));
+    fused.run(graph, annotated);
+}
+
+dfs_visitor chain_visitor(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (const dfs_chain&)> output_func, const uint8_t pass){
+    dfs_visitor visitor;
+    visitor.pass = pass;
+    // nodes already in a chain
+    std::shared_ptr<RSBitmap> visited = std::make_shared<RSBitmap>(graph.n());
+    visitor.prepare = [visited](){
+        visited->clear();
+    };
+    visitor.preprocess = [&graph, &annotated, output_func, visited](SFL_ID_SIZE node, SFL_POS_SIZE size, bool){
+        const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+        if (size==0)
+            return true;
+        dfs_chain chain;
+        chain.node = node;
+        chain.edge = annotated.select_segment_pos(std::get<edges_backlink>(annotated.arrays), node, 1);
+        while(chain.edge!=0){
+            visited->set(node, true);
+            // climb up from the descendant until a node of an earlier chain (or node itself) is reached
+            chain.end = graph.head(node, chain.edge);
+            chain.length = 1;
+            while(!visited->get(chain.end)){
+                visited->set(chain.end, true);
+                chain.end = graph.head(chain.end, annotated.select_segment_pos(parents, chain.end, 1));
+                chain.length++;
+            }
+            output_func(chain);
+            chain.edge = annotated.select_segment_pos(std::get<edges_backlink>(annotated.arrays), node, chain.edge+1);
+        }
+        return true;
+    };
+    return visitor;
+}
+
+uint64_t chain_decomposition(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (const dfs_chain&)> output_func){
+    uint64_t chains=0;
+    FusedTraversal fused;
+    fused.add(chain_visitor(graph, annotated, [&chains, &output_func](const dfs_chain &chain){
+        chains++;
+        output_func(chain);
+    }, 0));
+    fused.run(graph, annotated);
+    return chains;
+}
+
+const std::vector<dfs_chain> chain_decomposition(const SFLGraph &graph, const annotated_edges_t &annotated){
+    std::vector<dfs_chain> chains;
+    chain_decomposition(graph, annotated, [&chains](const dfs_chain &chain){chains.push_back(chain);});
+    return chains;
+}
+
+void chain_edges(const SFLGraph &graph, const annotated_edges_t &annotated, const dfs_chain &chain, std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> output_func){
+    const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+    SFL_ID_SIZE node = graph.head(chain.node, chain.edge);
+    SFL_POS_SIZE edge;
+    output_func(chain.node, chain.edge);
+    for(uint64_t counter=1; counter<chain.length; counter++){
+        edge = annotated.select_segment_pos(parents, node, 1);
+        output_func(node, edge);
+        node = graph.head(node, edge);
+    }
+    assert(node==chain.end);
+}
+
+connectivity_certificate chain_certificate(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes){
+    const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+    connectivity_certificate certificate;
+    // tree edges covered by a chain, stored at the child
+    RSBitmap covered(graph.n());
+    bool component_has_cycle=false;
+    dfs_visitor roots;
+    roots.pass = 0;
+    roots.preprocess = [&certificate, &component_has_cycle, &removednodes](SFL_ID_SIZE node, SFL_POS_SIZE, bool is_root){
+        if (removednodes.get(node))
             return false;
+        certificate.nodes++;
+        if (is_root){
+            certificate.components++;
+            component_has_cycle = false;
+        }
         return true;
     };
-    dfs(graph, annotated, 0,
-        dfs_placeholder, dfs_placeholder, marking);
+    FusedTraversal fused;
+    fused.add(roots);
+    fused.add(chain_visitor(graph, annotated, [&](const dfs_chain &chain){
+        certificate.chains++;
+        if (chain.cycle()){
+            certificate.cycles++;
+            // the first cycle of a component is the only one which doesn't start at a cut vertex
+            if (component_has_cycle && certificate.cut_vertex==0)
+                certificate.cut_vertex = chain.node;
+            component_has_cycle = true;
+        }
+        chain_edges(graph, annotated, chain, [&covered, &chain](SFL_ID_SIZE node, SFL_POS_SIZE){
+            if (node!=chain.node)
+                covered.set(node, true);
+        });
+    }, 0));
+    fused.run(graph, annotated);
+    // every tree edge without chain is a bridge, back edges are always in a chain
+    auto effective_deg = [&graph, &removednodes](SFL_ID_SIZE node){
+        SFL_POS_SIZE deg=0;
+        for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++)
+            deg += !removednodes.get(graph.head(node, edge));
+        return deg;
+    };
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        SFL_POS_SIZE parent_edge = annotated.segment_size(node)>0 ? annotated.select_segment_pos(parents, node, 1) : 0;
+        if (removednodes.get(node) || parent_edge==0 || covered.get(node))
+            continue;
+        certificate.bridges++;
+        if (certificate.bridge_node==0){
+            certificate.bridge_node = node;
+            certificate.bridge_edge = parent_edge;
+        }
+        if (certificate.cut_vertex==0){
+            if (effective_deg(node)>=2)
+                certificate.cut_vertex = node;
+            else if (effective_deg(graph.head(node, parent_edge))>=2)
+                certificate.cut_vertex = graph.head(node, parent_edge);
+        }
+    }
+    certificate.two_edge_connected = certificate.components==1 && certificate.nodes>=2 && certificate.bridges==0;
+    certificate.two_vertex_connected = certificate.two_edge_connected && certificate.cut_vertex==0;
+    return certificate;
 }
 
-// with ignored nodes
-void update_edges(const SFLGraph &graph, annotated_edges_t &annotated, const RSBitmap &removednodes){
-    if(std::get<edges_parent>(annotated.arrays).is_static())
-        annotated.reset<edges_parent>();
-    if(std::get<edges_backlink>(annotated.arrays).is_static())
-        annotated.reset<edges_backlink>();
-    if(std::get<edge_marks>(annotated.arrays).is_static())
-        annotated.reset<edge_marks>();
+uint64_t open_ear_decomposition(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (const dfs_chain&)> output_func){
+    SFLCHECK(chain_certificate(graph, annotated).two_vertex_connected)
+    return chain_decomposition(graph, annotated, output_func);
+}
+
+const BitPackedArray st_numbering(const SFLGraph &graph, const annotated_edges_t &annotated){
+    SFLCHECK(graph.n()>=2)
+    const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+    const uint8_t width = BitPackedArray::calc_width(graph.n());
+    // preorder number and lowest preorder number reachable from the subtree with one back edge
+    BitPackedArray pre(graph.n(), width), low(graph.n(), width);
+    // list of nodes in st-order
+    BitPackedArray prev(graph.n(), width), next(graph.n(), width);
+    // sign of every node (indexed by preorder number), true for minus
+    RSBitmap minus(graph.n());
+    uint64_t counter=0, roots=0;
+    SFL_ID_SIZE s=0, t=0;
+
+    dfs_visitor numbers;
+    numbers.pass = 0;
+    numbers.preprocess = [&pre, &counter, &roots](SFL_ID_SIZE node, SFL_POS_SIZE, bool is_root){
+        pre.set(node, ++counter);
+        roots += is_root;
+        return true;
+    };
+    numbers.postprocess = [&graph, &annotated, &parents, &pre, &low](SFL_ID_SIZE node, SFL_POS_SIZE){
+        uint64_t node_low = pre.get(node);
+        SFL_ID_SIZE next_node;
+        SFL_POS_SIZE back_edge;
+        const SFL_POS_SIZE parent_edge = annotated.select_segment_pos(parents, node, 1);
+        for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            if (edge==parent_edge)
+                continue;
+            std::tie(next_node, back_edge) = graph.mate(node, edge);
+            // children are finished, all other neighbors with a lower number are ancestors
+            if (parents.get(annotated.get_pos(next_node, back_edge)))
+                node_low = std::min(node_low, low.get(next_node));
+            else
+                node_low = std::min(node_low, pre.get(next_node));
+        }
+        low.set(node, node_low);
+    };
+    dfs_visitor insert;
+    insert.pass = 1;
+    insert.prepare = [&roots](){
+        // connected
+        SFLCHECK(roots==1)
+    };
+    insert.preprocess = [&](SFL_ID_SIZE node, SFL_POS_SIZE, bool is_root){
+        if (is_root){
+            s = node;
+            minus.set(pre.get(s), true);
+            return true;
+        }
+        const SFL_ID_SIZE parent = graph.head(node, annotated.select_segment_pos(parents, node, 1));
+        if (parent==s){
+            // the root has only one child
+            SFLCHECK(t==0)
+            t = node;
+            next.set(s, t);
+            prev.set(t, s);
+            return true;
+        }
+        // parent is no cut vertex
+        SFLCHECK(low.get(node)<pre.get(parent))
+        if (minus.get(low.get(node))){
+            // insert before parent
+            const SFL_ID_SIZE before = prev.get(parent);
+            assert(before!=0);
+            next.set(before, node);
+            prev.set(node, before);
+            next.set(node, parent);
+            prev.set(parent, node);
+            minus.set(pre.get(parent), false);
+        } else {
+            // insert after parent
+            const SFL_ID_SIZE after = next.get(parent);
+            if (after!=0)
+                prev.set(after, node);
+            next.set(node, after);
+            prev.set(node, parent);
+            next.set(parent, node);
+            minus.set(pre.get(parent), true);
+        }
+        return true;
+    };
+    FusedTraversal fused;
+    fused.add(numbers);
+    fused.add(insert);
+    fused.run(graph, annotated);
+    BitPackedArray numbering(graph.n(), width);
+    counter = 0;
+    for(SFL_ID_SIZE node=s; node!=0; node=next.get(node))
+        numbering.set(node, ++counter);
+    assert(counter==graph.n());
+    assert(numbering.get(t)==graph.n());
+    return numbering;
+}
+
+dfs_visitor annotate_visitor(const SFLGraph &graph, annotated_edges_t &annotated, const RSBitmap &removednodes){
+    dfs_visitor visitor;
+    visitor.pass = 0;
+    visitor.prepare = [&annotated](){
+        if(std::get<edges_parent>(annotated.arrays).is_static())
+            annotated.reset<edges_parent>();
+        if(std::get<edges_backlink>(annotated.arrays).is_static())
+            annotated.reset<edges_backlink>();
+    };
 #ifndef NDEBUG
-    uint64_t roots=0;
-    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> preprocess = [&annotated, &roots, &removednodes](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
+    // shared between preprocess and finish
+    std::shared_ptr<uint64_t> roots = std::make_shared<uint64_t>(0);
+    visitor.preprocess = [&annotated, roots, &removednodes](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
         if (is_root && annotated.segment_size(node)>0){
             // count root nodes with not empty segment
-            roots++;
+            (*roots)++;
         }
 #else
-    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> preprocess = [&annotated, &removednodes](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
+    visitor.preprocess = [&removednodes](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
 #endif
         if (removednodes.get(node))
             return false;
         return true;
     };
-
-    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> dfs_tree_climb_down = [&graph, &annotated, &removednodes](SFL_ID_SIZE last, SFL_POS_SIZE edge, SFL_ID_SIZE next, uint8_t color) {
+    visitor.preexplore = [&graph, &annotated, &removednodes](SFL_ID_SIZE last, SFL_POS_SIZE edge, SFL_ID_SIZE next, uint8_t color) {
         if (removednodes.get(next))
             return false;
-        //uint64_t arrpos = backlinks_ret.get_pos(last, edge);
         uint64_t parentarrpos = annotated.get_pos(next,std::get<1>(graph.mate(last, edge)));
         if (color==white){
             // climb down; normal case
             annotated.set<edges_parent>(parentarrpos, true);
-            //assert(backlinks_ret.get<edges_parent>(arrpos)==false);
         } else if(color!=black){
             // = gray or darkgray and not parent
             // mark in parent which edges are backlinks
             annotated.set<edges_backlink>(parentarrpos, true);
-            //assert(backlinks_ret.get<edges_backlink>(parentarrpos)==false);
         }
         return true;
     };
-    dfs(graph, annotated, 0, dfs_tree_climb_down, dfs_placeholder, preprocess);
-    std::get<edges_parent>(annotated.arrays).make_static();
-    std::get<edges_backlink>(annotated.arrays).make_static();
-    // initialize mark array
-    mark_edges(graph, annotated, std::get<edge_marks>(annotated.arrays));
+#ifndef NDEBUG
+    visitor.finish = [&annotated, roots, &removednodes](){
+#else
+    visitor.finish = [&annotated](){
+#endif
+        std::get<edges_parent>(annotated.arrays).make_static();
+        std::get<edges_backlink>(annotated.arrays).make_static();
+#ifndef NDEBUG
+        if (removednodes.ones()==0){
+            assert(annotated.segments()-annotated.all_empty() == std::get<edges_parent>(annotated.arrays).ones()+*roots);
+        }
+#endif
+    };
+    return visitor;
+}
+
+// with ignored nodes
+void update_edges(const SFLGraph &graph, annotated_edges_t &annotated, const RSBitmap &removednodes){
+    if(std::get<edge_marks>(annotated.arrays).is_static())
+        annotated.reset<edge_marks>();
+    // parents and backlinks in pass 0, marks in pass 1
+    FusedTraversal fused;
+    fused.add(annotate_visitor(graph, annotated, removednodes));
+    fused.add(mark_visitor(graph, annotated, std::get<edge_marks>(annotated.arrays), removednodes));
+    fused.run(graph, annotated);
     // make static
     std::get<edge_marks>(annotated.arrays).make_static();
     //
     assert(std::get<edges_parent>(annotated.arrays).is_static());
     assert(std::get<edge_marks>(annotated.arrays).is_static());
-#ifndef NDEBUG
-    if (removednodes.ones()==0){
-        assert(annotated.segments()-annotated.all_empty() == std::get<edges_parent>(annotated.arrays).ones()+roots);
-    }
-#endif
 }
 
 annotated_edges_t annotate_edges(const SFLGraph &graph, const RSBitmap &removednodes){
@@ -454,6 +912,242 @@ annotated_edges_t annotate_edges(const SFLGraph &graph, const RSBitmap &removedn
 }
 
 
+const RSBitmap spanning_forest(const SFLGraph &graph, const annotated_edges_t &annotated){
+    const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+    SFL_ID_SIZE parent;
+    SFL_POS_SIZE parent_edge, child_edge;
+    RSBitmap forest(annotated.size());
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        if (annotated.segment_size(node)==0)
+            continue;
+        parent_edge = annotated.select_segment_pos(parents, node, 1);
+        // root
+        if (parent_edge==0)
+            continue;
+        std::tie(parent, child_edge) = graph.mate(node, parent_edge);
+        forest.set(annotated.get_pos(node, parent_edge), true);
+        forest.set(annotated.get_pos(parent, child_edge), true);
+    }
+    forest.make_static();
+    return forest;
+}
+
+edge_layout_t edge_layout(const SFLGraph &graph){
+    return edge_layout_t(graph.begin_deg(), graph.end_deg());
+}
+
+ForestCSR::ForestCSR(const SFLGraph &graph, const RSBitmap &forest):
+parents(graph.n(), BitPackedArray::calc_width(graph.n())),
+offsets(graph.n()+1, BitPackedArray::calc_width(graph.n())),
+children_(graph.n(), BitPackedArray::calc_width(graph.n())){
+    const edge_layout_t layout = edge_layout(graph);
+    SFLCHECK(forest.n()==layout.size())
+    RSBitmap visited(graph.n());
+    SFL_ID_SIZE node, next_node, queue_head=1, tail=0;
+    uint64_t segment_begin;
+    // orient every tree from its lowest node, children_ is the queue of a breadth-first-search
+    for(SFL_ID_SIZE root=1; root<=graph.n(); root++){
+        if (visited.get(root))
+            continue;
+        visited.set(root, true);
+        children_.set(++tail, root);
+        for(; queue_head<=tail; queue_head++){
+            node = children_.get(queue_head);
+            if (graph.deg(node)==0)
+                continue;
+            segment_begin = layout.get_pos(node, 1);
+            for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                next_node = graph.head(node, edge);
+                if (!forest.get(segment_begin+edge-1) || visited.get(next_node))
+                    continue;
+                visited.set(next_node, true);
+                parents.set(next_node, node);
+                children_.set(++tail, next_node);
+            }
+        }
+    }
+    assert(tail==graph.n());
+    // counting sort of the children by parent, count of a node is stored at the next node
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        if (parents.get(node)!=0)
+            offsets.set(parents.get(node)+1, offsets.get(parents.get(node)+1)+1);
+    }
+    for(SFL_ID_SIZE node=2; node<=graph.n()+1; node++)
+        offsets.set(node, offsets.get(node)+offsets.get(node-1));
+    // offsets of a node are moved forward while filling and end at the begin of the next node
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        SFL_ID_SIZE parent = parents.get(node);
+        if (parent==0)
+            continue;
+        offsets.set(parent, offsets.get(parent)+1);
+        children_.set(offsets.get(parent), node);
+    }
+    for(SFL_ID_SIZE node=graph.n()+1; node>=2; node--)
+        offsets.set(node, offsets.get(node-1));
+    offsets.set(1, 0);
+    // remainder of the queue
+    for(SFL_ID_SIZE pos=offsets.get(graph.n()+1)+1; pos<=graph.n(); pos++)
+        children_.set(pos, 0);
+}
+
+space_summary annotation_space(const SFLGraph &graph, const annotated_edges_t &annotated){
+    space_summary summary;
+    summary.report = annotated.space_report();
+    summary.bytes = summary.report.total();
+    if (graph.n()>0)
+        summary.bits_per_node = 8.0*summary.bytes/graph.n();
+    // every edge has two positions
+    if (annotated.size()>0)
+        summary.bits_per_edge = 16.0*summary.bytes/annotated.size();
+    return summary;
+}
+
+dfs_visitor components_visitor(uint64_t &components, std::function<void (SFL_ID_SIZE, bool)>output_func, const RSBitmap &removednodes, const uint8_t pass){
+    dfs_visitor visitor;
+    visitor.pass = pass;
+    visitor.preprocess = [output_func, &components, &removednodes](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
+        if (removednodes.get(node))
+            return false;
+        // every root starts a new component
+        if (is_root)
+            components++;
+        output_func(node, is_root);
+        return true;
+    };
+    visitor.preexplore = [&removednodes](SFL_ID_SIZE last, SFL_POS_SIZE edge, SFL_ID_SIZE next, uint8_t color) {
+        if (removednodes.get(next))
+            return false;
+        return true;
+    };
+    return visitor;
+}
+
+uint64_t connected_components(const SFLGraph &graph, std::function<void (SFL_ID_SIZE, bool)>output_func, const RSBitmap &removednodes){
+    uint64_t components=0;
+    FusedTraversal fused;
+    fused.add(components_visitor(components, output_func, removednodes));
+    fused.run(graph);
+    return components;
+}
+
+dfs_visitor degree_visitor(degree_stats &stats, const uint8_t pass){
+    dfs_visitor visitor;
+    visitor.pass = pass;
+    visitor.preprocess = [&stats](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
+        if (stats.nodes==0 || size<stats.min_deg)
+            stats.min_deg = size;
+        if (size>stats.max_deg)
+            stats.max_deg = size;
+        if (size==0)
+            stats.isolated++;
+        stats.sum_deg += size;
+        stats.nodes++;
+        return true;
+    };
+    return visitor;
+}
+
+// combine hooks with result, stops at first false
+template<typename... Args>
+static std::function<bool (Args...)> fuse_hooks(const std::vector<std::function<bool (Args...)>> &hooks){
+    if (hooks.empty())
+        return dfs_placeholder;
+    // no overhead for single analyses
+    if (hooks.size()==1)
+        return hooks[0];
+    return [hooks](Args... args){
+        for(const auto &hook: hooks){
+            if(!hook(args...))
+                return false;
+        }
+        return true;
+    };
+}
+
+// combine hooks without result
+template<typename... Args>
+static std::function<void (Args...)> fuse_hooks(const std::vector<std::function<void (Args...)>> &hooks){
+    if (hooks.empty())
+        return dfs_placeholder;
+    if (hooks.size()==1)
+        return hooks[0];
+    return [hooks](Args... args){
+        for(const auto &hook: hooks)
+            hook(args...);
+    };
+}
+
+void FusedTraversal::add(dfs_visitor visitor){
+    visitors.push_back(std::move(visitor));
+}
+
+fused_report FusedTraversal::_run(const SFLGraph &graph, const annotated_edges_t *annotated){
+    fused_report report;
+    report.analyses = visitors.size();
+    uint8_t last_pass=0;
+    for(const auto &visitor: visitors)
+        last_pass = std::max(last_pass, visitor.pass);
+    for(unsigned pass=0; pass<=last_pass && !visitors.empty(); pass++){
+        std::vector<std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)>> preexplore;
+        std::vector<std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)>> postexplore;
+        std::vector<std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)>> preprocess;
+        std::vector<std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)>> postprocess;
+        bool used=false;
+        for(const auto &visitor: visitors){
+            if (visitor.pass!=pass)
+                continue;
+            used=true;
+            if (visitor.prepare)
+                visitor.prepare();
+            if (visitor.preexplore)
+                preexplore.push_back(visitor.preexplore);
+            if (visitor.postexplore)
+                postexplore.push_back(visitor.postexplore);
+            if (visitor.preprocess)
+                preprocess.push_back(visitor.preprocess);
+            if (visitor.postprocess)
+                postprocess.push_back(visitor.postprocess);
+        }
+        // empty passes are skipped
+        if (!used)
+            continue;
+        if (annotated)
+            dfs(graph, *annotated, 0, fuse_hooks(preexplore), fuse_hooks(postexplore), fuse_hooks(preprocess), fuse_hooks(postprocess));
+        else
+            dfs(graph, 0, fuse_hooks(preexplore), fuse_hooks(postexplore), fuse_hooks(preprocess), fuse_hooks(postprocess));
+        report.passes++;
+        for(const auto &visitor: visitors){
+            if (visitor.pass==pass && visitor.finish)
+                visitor.finish();
+        }
+    }
+    report.passes_saved = report.analyses-report.passes;
+    return report;
+}
+
+fused_report FusedTraversal::run(const SFLGraph &graph){
+    return _run(graph, nullptr);
+}
+
+fused_report FusedTraversal::run(const SFLGraph &graph, const annotated_edges_t &annotated){
+    return _run(graph, &annotated);
+}
+
+const BitPackedArray connected_components(const SFLGraph &graph, const RSBitmap &removednodes){
+    // first pass: count components for the label width
+    uint64_t components = connected_components(graph, [](SFL_ID_SIZE, bool){}, removednodes);
+    BitPackedArray labels(graph.n(), BitPackedArray::calc_width(components));
+    uint64_t label=0;
+    std::function<void (SFL_ID_SIZE, bool)> output_func = [&labels, &label](SFL_ID_SIZE node, bool new_component) {
+        if (new_component)
+            label++;
+        labels.set(node, label);
+    };
+    connected_components(graph, output_func, removednodes);
+    assert(label==components);
+    return labels;
+}
+
 const RSBitmap cutvertices(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes){
     const marked_edges_t &marks = std::get<edge_marks>(annotated.arrays);
     SFL_POS_SIZE deg;
@@ -494,52 +1188,53 @@ const RSBitmap cutvertices(const SFLGraph &graph, const annotated_edges_t &annot
     return cutvertices_ret;
 }
 
-void biconnected_components(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (SFL_ID_SIZE, bool)>output_func, const RSBitmap &removednodes){
-    SFL_ID_SIZE node, parent_node;
-    uint64_t edge;
+// visit the nodes below start which are in the same block, start has to be the first node below the top
+// walks the subtree over full marked tree edges, climbs up with the parent edges instead of a stack
+template<class Visit_t>
+static void walk_block(const SFLGraph &graph, const annotated_edges_t &annotated, const SFL_ID_SIZE start, const RSBitmap &removednodes, Visit_t visit){
+    SFL_ID_SIZE cur_node=start, next_node;
+    SFL_POS_SIZE edge, next_edge=1, back_edge;
     const marked_edges_t &marks = std::get<edge_marks>(annotated.arrays);
     const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
-
-    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> preprocess = [&annotated, &removednodes](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
-        if (removednodes.get(node))
-            return false;
-        return true;
-    };
-
-    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> cc_and_stop = [&annotated, &marks, &output_func, &parent_node, &removednodes](SFL_ID_SIZE last, SFL_POS_SIZE edge, SFL_ID_SIZE next, uint8_t color) {
-        if(removednodes.get(next))
-            return false;
-        // block real start node, as the algorithm could traverse in other biconnected components
-        if(next==parent_node){
-            return false;
-        }
-        // black and gray nodes should be ignored:
-        // they are either already in the bitmap or unrelated or already processed
-        // last 2 cases cause errors
-        if (color!=white)
-            return true;
-        uint8_t mark = marks.get(annotated.get_pos(last, edge));
-        if (mark==full_marked) {
-            output_func(next, false);
-            return true;
+    while(true){
+        if (next_edge<=graph.deg(cur_node)){
+            edge = next_edge++;
+            std::tie(next_node, back_edge) = graph.mate(cur_node, edge);
+            if (removednodes.get(next_node))
+                continue;
+            // child in the same block
+            if (parents.get(annotated.get_pos(next_node, back_edge)) && marks.get(annotated.get_pos(cur_node, edge))==full_marked){
+                visit(next_node);
+                cur_node = next_node;
+                next_edge = 1;
+            }
+            continue;
         }
-        return false;
-    };
-    for(node=1; node<graph.n();node++){
+        if (cur_node==start)
+            break;
+        // continue at parent after the edge to cur_node
+        std::tie(cur_node, next_edge) = graph.mate(cur_node, annotated.select_segment_pos(parents, cur_node, 1));
+        next_edge++;
+    }
+}
+
+void biconnected_components(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (SFL_ID_SIZE, bool)>output_func, const RSBitmap &removednodes){
+    SFL_POS_SIZE edge;
+    const marked_edges_t &marks = std::get<edge_marks>(annotated.arrays);
+    const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+    // a half marked parent edge starts a block below the parent, a full marked one continues the block of the parent.
+    // Every node is walked once as non-first member of a block, so the whole search is O(n+m).
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
         if (removednodes.get(node))
             continue;
         edge = annotated.select_segment_pos(parents, node, 1);
-        // is empty
-        if(edge==0)
+        // root or empty
+        if(edge==0 || marks.get(annotated.get_pos(node, edge))!=half_marked)
             continue;
-        if(marks.get(annotated.get_pos(node, edge))==half_marked){
-            parent_node = graph.head(node, edge);
-            // parent_node, won't be printed elsewise
-            output_func(parent_node, true);
-            // start_node (half marked is barrier)
-            output_func(node, false);
-            dfs(graph, annotated, node, cc_and_stop, dfs_placeholder, preprocess);
-        }
+        // parent_node (cut vertex or root), won't be printed elsewise
+        output_func(graph.head(node, edge), true);
+        output_func(node, false);
+        walk_block(graph, annotated, node, removednodes, [&output_func](SFL_ID_SIZE member){output_func(member, false);});
     }
 }
 
@@ -557,3 +1252,432 @@ const std::vector<std::vector<SFL_ID_SIZE>> biconnected_components(const SFLGrap
     biconnected_components(graph, annotated, output_func, removednodes);
     return cc_ret;
 }
+
+// reduces a block by removing nodes of degree 2, the edge between their neighbors becomes an outer edge.
+// An existing outer edge between the neighbors closes the outer cycle, so only a triangle may be left.
+static bool outerplanar_block(const SFLGraph &graph, const std::vector<SFL_ID_SIZE> &block_nodes, std::vector<SFL_ID_SIZE> &local_id, const RSBitmap &removednodes){
+    const SFL_ID_SIZE block_n = block_nodes.size();
+    // edges inside the block with local node ids, lists keep removed edges
+    std::vector<std::vector<SFL_ID_SIZE>> adjacency(block_n);
+    std::vector<SFL_POS_SIZE> deg(block_n, 0);
+    uint64_t block_m=0;
+    for(SFL_ID_SIZE counter=0; counter<block_n; counter++)
+        local_id[block_nodes[counter]-1] = counter+1;
+    for(SFL_ID_SIZE counter=0; counter<block_n; counter++){
+        const SFL_ID_SIZE node = block_nodes[counter];
+        for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            SFL_ID_SIZE next_node = graph.head(node, edge);
+            // two nodes of a block can't share an edge of another block
+            if (removednodes.get(next_node) || local_id[next_node-1]==0)
+                continue;
+            adjacency[counter].push_back(local_id[next_node-1]);
+            deg[counter]++;
+            block_m++;
+        }
+    }
+    for(SFL_ID_SIZE node: block_nodes)
+        local_id[node-1] = 0;
+    block_m /= 2;
+    // outerplanar graphs are sparse
+    if (block_m>2*block_n-3)
+        return false;
+    auto key = [](SFL_ID_SIZE node1, SFL_ID_SIZE node2){
+        if (node1>node2)
+            std::swap(node1, node2);
+        return (static_cast<uint64_t>(node1)<<32)|node2;
+    };
+    // existing edges, true for edges on the outer cycle
+    std::unordered_map<uint64_t, bool> outer;
+    outer.reserve(2*block_m);
+    std::vector<SFL_ID_SIZE> candidates;
+    for(SFL_ID_SIZE node=1; node<=block_n; node++){
+        for(SFL_ID_SIZE next_node: adjacency[node-1])
+            outer.emplace(key(node, next_node), false);
+        if (deg[node-1]==2)
+            candidates.push_back(node);
+    }
+    std::vector<bool> reduced(block_n, false);
+    SFL_ID_SIZE remaining = block_n;
+    while(remaining>3){
+        if (candidates.empty())
+            return false;
+        SFL_ID_SIZE node = candidates.back();
+        candidates.pop_back();
+        if (reduced[node-1] || deg[node-1]!=2)
+            continue;
+        SFL_ID_SIZE ends[2] = {0, 0};
+        uint8_t found=0;
+        for(SFL_ID_SIZE next_node: adjacency[node-1]){
+            if (outer.count(key(node, next_node)))
+                ends[found++] = next_node;
+        }
+        assert(found==2);
+        outer.erase(key(node, ends[0]));
+        outer.erase(key(node, ends[1]));
+        reduced[node-1] = true;
+        remaining--;
+        auto it = outer.find(key(ends[0], ends[1]));
+        if (it==outer.end()){
+            // replace the path over node
+            outer.emplace(key(ends[0], ends[1]), true);
+            adjacency[ends[0]-1].push_back(ends[1]);
+            adjacency[ends[1]-1].push_back(ends[0]);
+            continue;
+        }
+        if (it->second)
+            return false;
+        it->second = true;
+        for(SFL_ID_SIZE end: ends){
+            if (--deg[end-1]==2)
+                candidates.push_back(end);
+        }
+    }
+    return true;
+}
+
+// checks all blocks, or stops checking after the first failure
+static uint64_t _outerplanar_blocks(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (uint64_t, bool)> &output_func, const RSBitmap &removednodes, const bool stop_at_failure){
+    std::vector<SFL_ID_SIZE> local_id(graph.n(), 0);
+    std::vector<SFL_ID_SIZE> block_nodes;
+    uint64_t block=0, failures=0;
+    auto check_block = [&](){
+        if (block_nodes.empty() || (stop_at_failure && failures>0))
+            return;
+        bool outerplanar = outerplanar_block(graph, block_nodes, local_id, removednodes);
+        failures += !outerplanar;
+        output_func(block, outerplanar);
+    };
+    biconnected_components(graph, annotated, [&](SFL_ID_SIZE node, bool new_component){
+        if (new_component){
+            check_block();
+            block_nodes.clear();
+            block++;
+        }
+        block_nodes.push_back(node);
+    }, removednodes);
+    check_block();
+    return failures;
+}
+
+uint64_t outerplanar_blocks(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (uint64_t, bool)>output_func, const RSBitmap &removednodes){
+    return _outerplanar_blocks(graph, annotated, output_func, removednodes, false);
+}
+
+bool is_outerplanar(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes){
+    std::function<void (uint64_t, bool)> output_func = [](uint64_t, bool){};
+    return _outerplanar_blocks(graph, annotated, output_func, removednodes, true)==0;
+}
+
+//! iterator for the amount of blocks below every node
+/*! \class TopCountIterator
+*/
+class TopCountIterator : public uint64_iterator
+{
+    const SFLGraph &graph;
+    const annotated_edges_t &annotated;
+    const RSBitmap &removednodes;
+    SFL_ID_SIZE node;
+public:
+    //! constructor
+    /*!
+        \param graph_ Graph object
+        \param annotated_ annotated_edges
+        \param removednodes_ RSBitmap with removed nodes
+        \param node_ current node
+    */
+    TopCountIterator(const SFLGraph &graph_, const annotated_edges_t &annotated_, const RSBitmap &removednodes_, SFL_ID_SIZE node_):
+    graph(graph_), annotated(annotated_), removednodes(removednodes_), node(node_){}
+    //! copy constructor
+    TopCountIterator(const TopCountIterator& mit): graph(mit.graph), annotated(mit.annotated), removednodes(mit.removednodes), node(mit.node) {}
+    //! prefix ++
+    TopCountIterator& operator++() {++node;return *this;}
+    //! postfix ++
+    TopCountIterator operator++(int) {TopCountIterator tmp(*this); operator++(); return tmp;}
+    //! compare iterators !=
+    bool operator!=(const TopCountIterator& rhs) const {return node!=rhs.node;}
+    //! get amount of half marked child edges
+    uint64_t operator*() {
+        const marked_edges_t &marks = std::get<edge_marks>(annotated.arrays);
+        const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+        SFL_ID_SIZE next_node;
+        SFL_POS_SIZE back_edge;
+        uint64_t count=0;
+        if (removednodes.get(node))
+            return 0;
+        for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            std::tie(next_node, back_edge) = graph.mate(node, edge);
+            if (removednodes.get(next_node))
+                continue;
+            uint64_t pos = annotated.get_pos(next_node, back_edge);
+            if (parents.get(pos) && marks.get(pos)==half_marked)
+                count++;
+        }
+        return count;
+    }
+};
+
+const BlockLabels biconnected_labels(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes){
+    const marked_edges_t &marks = std::get<edge_marks>(annotated.arrays);
+    const parent_edges_t& parents = std::get<edges_parent>(annotated.arrays);
+    SFL_ID_SIZE next_node;
+    SFL_POS_SIZE back_edge;
+    // first pass: count the blocks of every top, the array size is the amount of blocks
+    SegmentedArray<> tops(TopCountIterator(graph, annotated, removednodes, 1), TopCountIterator(graph, annotated, removednodes, graph.n()+1));
+    BitPackedArray labels(graph.n(), BitPackedArray::calc_width(tops.size()));
+    // second pass: number the blocks in the same order
+    uint64_t block=0;
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        if (removednodes.get(node))
+            continue;
+        for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            std::tie(next_node, back_edge) = graph.mate(node, edge);
+            if (removednodes.get(next_node))
+                continue;
+            uint64_t pos = annotated.get_pos(next_node, back_edge);
+            if (!parents.get(pos) || marks.get(pos)!=half_marked)
+                continue;
+            block++;
+            assert(tops.get_pos(node, tops.segment_size(node))>=block);
+            labels.set(next_node, block);
+            walk_block(graph, annotated, next_node, removednodes, [&labels, block](SFL_ID_SIZE member){labels.set(member, block);});
+        }
+    }
+    assert(block==tops.size());
+    return BlockLabels(std::move(labels), std::move(tops));
+}
+
+IncrementalBlocks::IncrementalBlocks(const IncrementalBlocks& other):
+parents(other.parents.copy()), edge_elements(other.edge_elements.copy()), sets(other.sets.copy()),
+incident(other.incident.copy()), bridges(other.bridges.copy()), visited(other.visited.copy()),
+cutvertices_(other.cutvertices_), blocks_(other.blocks_){}
+
+IncrementalBlocks::IncrementalBlocks(const SFLGraph &graph, const annotated_edges_t &annotated):
+parents(graph.n(), BitPackedArray::calc_width(graph.n())),
+edge_elements(graph.n(), BitPackedArray::calc_width(graph.n())),
+sets(graph.n(), BitPackedArray::calc_width(graph.n())),
+incident(graph.n(), BitPackedArray::calc_width(graph.n())),
+bridges(graph.n()), visited(graph.n()){
+    const parent_edges_t& parent_edges = std::get<edges_parent>(annotated.arrays);
+    const marked_edges_t &marks = std::get<edge_marks>(annotated.arrays);
+    SFL_POS_SIZE parent_edge;
+    SFL_ID_SIZE parent;
+    uint8_t mark;
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        edge_elements.set(node, node);
+        sets.set(node, node);
+    }
+    for(SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        if (annotated.segment_size(node)==0)
+            continue;
+        parent_edge = annotated.select_segment_pos(parent_edges, node, 1);
+        // root
+        if (parent_edge==0)
+            continue;
+        parent = graph.head(node, parent_edge);
+        parents.set(node, parent);
+        mark = marks.get(annotated.get_pos(node, parent_edge));
+        _add_incident(node, 1);
+        if (mark==full_marked){
+            // same block as the parent edge of parent
+            assert(annotated.select_segment_pos(parent_edges, parent, 1)!=0);
+            _link(_find(node), _find(parent));
+        } else {
+            _add_incident(parent, 1);
+            if (mark==unmarked)
+                bridges.set(node, true);
+            else
+                blocks_++;
+        }
+    }
+}
+
+uint64_t IncrementalBlocks::_find(uint64_t elem){
+    uint64_t grandparent;
+    while (sets.get(elem)!=elem){
+        grandparent = sets.get(sets.get(elem));
+        sets.set(elem, grandparent);
+        elem = grandparent;
+    }
+    return elem;
+}
+
+uint64_t IncrementalBlocks::_link(const uint64_t root1, const uint64_t root2){
+    if (root1<root2){
+        sets.set(root2, root1);
+        return root1;
+    }
+    sets.set(root1, root2);
+    return root2;
+}
+
+void IncrementalBlocks::_add_incident(const SFL_ID_SIZE node, const int64_t diff){
+    const uint64_t old_count = incident.get(node);
+    const uint64_t new_count = old_count+diff;
+    if (old_count<2 && new_count>=2)
+        cutvertices_++;
+    else if (old_count>=2 && new_count<2)
+        cutvertices_--;
+    incident.set(node, new_count);
+}
+
+uint64_t IncrementalBlocks::_merge_path(const SFL_ID_SIZE start, const SFL_ID_SIZE stop, uint64_t &nonbridges){
+    uint64_t previous=0, root;
+    for (SFL_ID_SIZE node=start; node!=stop; node=parents.get(node)){
+        assert(node!=0);
+        root = _find(edge_elements.get(node));
+        // a path can't reenter a block, so this is the first edge of the next block
+        if (root!=previous){
+            // node is the cutvertex between both blocks
+            if (previous!=0)
+                _add_incident(node, -1);
+            if (!bridges.get(root))
+                nonbridges++;
+            bridges.set(root, false);
+            previous = previous==0 ? root : _link(previous, root);
+        }
+    }
+    return previous;
+}
+
+void IncrementalBlocks::insert(const SFL_ID_SIZE node1, const SFL_ID_SIZE node2){
+    SFLCHECK(node1!=0 && node2!=0)
+    SFLCHECK(node1<=n() && node2<=n())
+    SFLCHECK(node1!=node2)
+    // walk alternately upwards until one side reaches a node visited by the other side
+    SFL_ID_SIZE end1=node1, end2=node2, meet=0;
+    uint64_t steps1=0, steps2=0;
+    visited.set(node1, true);
+    visited.set(node2, true);
+    while (meet==0 && (parents.get(end1)!=0 || parents.get(end2)!=0)){
+        if (parents.get(end1)!=0){
+            end1 = parents.get(end1);
+            steps1++;
+            if (visited.get(end1)){
+                meet = end1;
+                break;
+            }
+            visited.set(end1, true);
+        }
+        if (parents.get(end2)!=0){
+            end2 = parents.get(end2);
+            steps2++;
+            if (visited.get(end2)){
+                meet = end2;
+                break;
+            }
+            visited.set(end2, true);
+        }
+    }
+    // clear visited
+    for (SFL_ID_SIZE node=node1; node!=end1; node=parents.get(node))
+        visited.set(node, false);
+    visited.set(end1, false);
+    for (SFL_ID_SIZE node=node2; node!=end2; node=parents.get(node))
+        visited.set(node, false);
+    visited.set(end2, false);
+    if (meet!=0){
+        uint64_t nonbridges=0;
+        const uint64_t root1 = _merge_path(node1, meet, nonbridges);
+        const uint64_t root2 = _merge_path(node2, meet, nonbridges);
+        if (root1!=0 && root2!=0){
+            const uint64_t found1 = _find(root1), found2 = _find(root2);
+            if (found1!=found2){
+                // meet is the cutvertex between the last blocks of both sides
+                _add_incident(meet, -1);
+                _link(found1, found2);
+            } else {
+                // both sides end in the same block, which was counted twice
+                nonbridges--;
+            }
+        }
+        blocks_ = blocks_+1-nonbridges;
+        return;
+    }
+    // different trees, reroot the tree with the shorter path at its endpoint and attach it
+    SFL_ID_SIZE top=node1, bottom=node2;
+    if (steps2>steps1){
+        std::swap(top, bottom);
+        std::swap(end1, end2);
+    }
+    // the unused element of the old root moves to bottom, the others one step down the path
+    uint64_t carry = edge_elements.get(end2), element;
+    SFL_ID_SIZE above=top, next;
+    for (SFL_ID_SIZE node=bottom; node!=0; node=next){
+        next = parents.get(node);
+        element = edge_elements.get(node);
+        edge_elements.set(node, carry);
+        parents.set(node, above);
+        carry = element;
+        above = node;
+    }
+    assert(sets.get(edge_elements.get(bottom))==edge_elements.get(bottom));
+    bridges.set(edge_elements.get(bottom), true);
+    _add_incident(top, 1);
+    _add_incident(bottom, 1);
+}
+
+uint64_t IncrementalBlocks::block(const SFL_ID_SIZE node){
+    if (parents.get(node)==0)
+        return 0;
+    const uint64_t root = _find(edge_elements.get(node));
+    return bridges.get(root) ? 0 : root;
+}
+
+const RSBitmap IncrementalBlocks::cutvertices() const{
+    RSBitmap cutvertices_ret(n());
+    for (SFL_ID_SIZE node=1; node<=n(); node++){
+        if (is_cutvertex(node))
+            cutvertices_ret.set(node, true);
+    }
+    cutvertices_ret.make_static();
+    return cutvertices_ret;
+}
+
+bool BlockLabels::contains(const SFL_ID_SIZE node, const uint64_t block) const{
+    if (block==0)
+        return false;
+    if (labels.get(node)==block)
+        return true;
+    uint64_t amount = tops.segment_size(node);
+    return amount>0 && tops.get_pos(node, 1)<=block && tops.get_pos(node, amount)>=block;
+}
+
+uint64_t BlockLabels::block_of_edge(const SFLGraph &graph, const SFL_ID_SIZE node, const SFL_POS_SIZE edge) const{
+    uint64_t block = labels.get(node);
+    uint64_t next_block = labels.get(graph.head(node, edge));
+    // both ends below the top, or a bridge between two nodes without a block over their parent edges
+    if (block==next_block)
+        return block;
+    // otherwise one end is the top of the block of the other end, or the edge is a bridge
+    if (next_block!=0 && contains(node, next_block))
+        return next_block;
+    if (block!=0 && contains(graph.head(node, edge), block))
+        return block;
+    return 0;
+}
+
+const RSBitmap cutvertices(const RelabeledGraph &relabeled, const annotated_edges_t &annotated){
+    const RSBitmap relabeled_cut = cutvertices(relabeled.graph(), annotated);
+    RSBitmap cutvertices_ret(relabeled_cut.n());
+    for (SFL_ID_SIZE node=1; node<=relabeled_cut.n(); node++){
+        if (relabeled_cut.get(node))
+            cutvertices_ret.set(relabeled.old_id(node), true);
+    }
+    cutvertices_ret.make_static();
+    return cutvertices_ret;
+}
+
+void biconnected_components(const RelabeledGraph &relabeled, const annotated_edges_t &annotated, std::function<void (SFL_ID_SIZE, bool)>output_func){
+    biconnected_components(relabeled.graph(), annotated, [&relabeled, &output_func](SFL_ID_SIZE node, bool new_component){
+        output_func(relabeled.old_id(node), new_component);
+    });
+}
+
+const std::vector<std::vector<SFL_ID_SIZE>> biconnected_components(const RelabeledGraph &relabeled, const annotated_edges_t &annotated){
+    std::vector<std::vector<SFL_ID_SIZE>> cc_ret = biconnected_components(relabeled.graph(), annotated);
+    for (auto &component: cc_ret){
+        for (SFL_ID_SIZE &node: component)
+            node = relabeled.old_id(node);
+    }
+    return cc_ret;
+}
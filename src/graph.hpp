@@ -14,6 +14,7 @@
 #include <tuple>
 #include <vector>
 #include <functional>
+#include <optional>
 
 //! color state of nodes
 /*! \enum node_color_state
@@ -70,6 +71,58 @@ const RSBitmap null_bitmap(1);
 //! placeholder for function parameter in dfs functions
 bool dfs_placeholder(...);
 
+//! reusable memory of dfs
+/*! \class DfsWorkspace
+    Owns the color bitmap and the stack of dfs. dfs clears the workspace in constant time before
+    searching, so repeated searches on the same graph don't allocate. The packed stack is sized for
+    the maximal degree at construction, dfs re-creates it if the graph got a higher degree since.
+*/
+class DfsWorkspace{
+    //! amount of nodes of the graph
+    SFL_ID_SIZE n_;
+    //! maximal edge position the stack can hold
+    SFL_POS_SIZE max_edge_;
+    //! create the stack for node ids up to n_ and edge positions up to max_edge_
+    void _create_stack();
+public:
+    //! stack segment size
+    const uint64_t q;
+    //! color of nodes, 2 bits per node
+    RSBitmap color;
+    //! stack with packed entries, used if node ids and edge positions fit
+    std::optional<PackedSpinStack> packed_stack;
+    //! stack with full entries, used otherwise
+    std::optional<SpinStack<AdjEntry>> stack;
+    //! Constructor
+    /*! \param graph Graph object the workspace is used for
+    */
+    DfsWorkspace(const SFLGraph &graph);
+    DfsWorkspace(const DfsWorkspace&) = delete;
+    //! amount of nodes of the graph
+    /*! \return amount of nodes
+    */
+    SFL_ID_SIZE n() const noexcept{
+        return n_;
+    }
+    //! maximal edge position
+    /*! \return maximal edge position the stack can hold (maximal degree+1 at creation)
+    */
+    SFL_POS_SIZE max_edge() const noexcept{
+        return max_edge_;
+    }
+    //! reset colors and stack in constant time
+    void clear();
+    //! prepare for a search on graph
+    /*! \param graph Graph object, must have the same amount of nodes
+        Re-creates the stack if the maximal degree of graph grew (SFLGraph::add_edge), then clears.
+    */
+    void prepare(const SFLGraph &graph);
+    //! used memory by component
+    /*! \return SpaceReport with color bitmap and stack
+    */
+    SpaceReport space_report() const;
+};
+
 //! depth-first-search over full graph or node
 /*! \param graph Graph object
     \param vertex start point for depth first search (0=search full graph)
@@ -84,6 +137,21 @@ void dfs(const SFLGraph &graph, const SFL_ID_SIZE vertex=0,
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess=dfs_placeholder,
     const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess=dfs_placeholder);
 
+//! depth-first-search over full graph or node with reused memory
+/*! \param graph Graph object
+    \param workspace workspace created for graph, cleared before searching
+    \param vertex start point for depth first search (0=search full graph)
+    \param preexplore prexplore hook, takes current node, current edge, next node, color next node
+    \param postexplore postexplore hook, takes parent node, current node, color current node
+    \param preprocess preprocess hook, returning false stops processing, executed before node is explored, takes current node, size, isroot
+    \param postprocess postprocess hook, executed after node is fully explored, takes current node, size
+*/
+void dfs(const SFLGraph &graph, DfsWorkspace &workspace, const SFL_ID_SIZE vertex=0,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore=dfs_placeholder,
+    const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore=dfs_placeholder,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess=dfs_placeholder,
+    const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess=dfs_placeholder);
+
 //! depth-first-search over full graph or node (faster version)
 /*! \param graph Graph object
     \param annotated annotated array containing correct parents till current node (parents can be updated in preexplore, see mark_edges for an example)
@@ -99,13 +167,144 @@ void dfs(const SFLGraph &graph, const annotated_edges_t &annotated, const SFL_ID
     const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess=dfs_placeholder,
     const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess=dfs_placeholder);
 
+//! depth-first-search over full graph or node (faster version) with reused memory
+/*! \param graph Graph object
+    \param annotated annotated array containing correct parents till current node
+    \param workspace workspace created for graph, only the colors are used, cleared before searching
+    \param vertex start point for depth first search (0=search full graph)
+    \param preexplore prexplore hook, takes current node, current edge, next node, color next node
+    \param postexplore postexplore hook, takes parent node, current node, color current node
+    \param preprocess preprocess hook, returning false stops processing, executed before node is explored, takes current node, size, isroot
+    \param postprocess postprocess hook, executed after node is fully explored, takes current node, size
+*/
+void dfs(const SFLGraph &graph, const annotated_edges_t &annotated, DfsWorkspace &workspace, const SFL_ID_SIZE vertex=0,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> &preexplore=dfs_placeholder,
+    const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> &postexplore=dfs_placeholder,
+    const std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> &preprocess=dfs_placeholder,
+    const std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> &postprocess=dfs_placeholder);
+
+//! type of a dfs event
+/*! \enum dfs_event_type
+*/
+typedef enum{
+    dfs_enter=0, // node is visited the first time
+    dfs_tree_edge=1, // edge leads to a not-visited node, which is entered next
+    dfs_back_edge=2, // edge leads to a node on the current path
+    dfs_leave=3 // node is completely explored
+} dfs_event_type;
+
+//! event of a pull-style depth-first-search
+/*! \struct dfs_event
+*/
+struct dfs_event{
+    //! type of event
+    dfs_event_type type;
+    //! current node
+    SFL_ID_SIZE node;
+    //! edge position for edge events, degree of node for dfs_enter and dfs_leave
+    SFL_POS_SIZE edge;
+    //! head of edge for edge events, 0 otherwise
+    SFL_ID_SIZE next;
+    //! is node root of a depth-first-search tree (dfs_enter only)
+    bool is_root;
+};
+
+//! pull-style depth-first-search over full graph or node
+/*! \class DfsEvents
+    Uses the same space-efficient engine as dfs but yields dfs_event objects on request
+    instead of calling hooks. Edges to black nodes and to the parent are not reported.
+    No allocations happen after construction, stopping early is done by not calling next() anymore.
+*/
+class DfsEvents{
+    //! graph to traverse
+    const SFLGraph &graph;
+    //! start point (0=search full graph)
+    const SFL_ID_SIZE vertex;
+    //! root of the current dfs tree
+    SFL_ID_SIZE cur_root=0;
+    //! next candidate for a root (full graph search)
+    SFL_ID_SIZE next_root=1;
+    //! stack segment size
+    const uint64_t q;
+    //! color of nodes
+    RSBitmap color;
+    //! stack of the engine
+    SpinStack<AdjEntry> Stack;
+    //! use darkgray instead of gray
+    bool restore_step=false;
+    //! entries of the current path were dropped from the stack
+    bool truncated=false;
+    //! events of the last step which are not consumed yet
+    dfs_event pending[2];
+    //! position of first pending event
+    uint8_t pending_first=0;
+    //! amount of pending events
+    uint8_t pending_count=0;
+    //! add pending event
+    void emit(dfs_event_type type, SFL_ID_SIZE node, SFL_POS_SIZE edge, SFL_ID_SIZE next, bool is_root);
+    //! find next root and push it, false if finished
+    bool next_tree();
+    //! execute one step of the engine, false if finished
+    bool step();
+public:
+    //! Constructor
+    /*! \param graph Graph object
+        \param vertex start point for depth first search (0=search full graph)
+    */
+    DfsEvents(const SFLGraph &graph, const SFL_ID_SIZE vertex=0);
+    DfsEvents(const DfsEvents&) = delete;
+    //! get next event
+    /*! \param event object which is overwritten with the next event
+        \return false if the search is finished
+    */
+    bool next(dfs_event &event);
+
+    //! input iterator over the remaining events
+    /*! \class iterator
+    */
+    class iterator{
+        //! events source, nullptr marks the end
+        DfsEvents *events;
+        //! current event
+        dfs_event current;
+    public:
+        //! Constructor
+        /*! \param events source or nullptr for the end
+        */
+        iterator(DfsEvents *events): events(events){}
+        //! prefix ++
+        iterator& operator++(){
+            if (!events->next(current))
+                events=nullptr;
+            return *this;
+        }
+        //! get event
+        const dfs_event& operator*() const {return current;}
+        //! access event
+        const dfs_event* operator->() const {return &current;}
+        //! compare iterators ==
+        bool operator==(const iterator& rhs) const {return events==rhs.events;}
+        //! compare iterators !=
+        bool operator!=(const iterator& rhs) const {return events!=rhs.events;}
+    };
+    //! iterator starting with the next event
+    iterator begin(){
+        iterator it(this);
+        return ++it;
+    }
+    //! end iterator
+    iterator end(){
+        return iterator(nullptr);
+    }
+};
+
 //! find node in adjacencearray of connected node
 /*! \param graph graph object
     \param base base node in which array the node should be searched
     \param search searched node
     \return 1-based position or 0
 */
-SFL_POS_SIZE find_pos_for_id(const SFLGraph &graph, const SFL_ID_SIZE base, const SFL_ID_SIZE search){
+inline SFL_POS_SIZE find_pos_for_id(const SFLGraph &graph, const SFL_ID_SIZE base, const SFL_ID_SIZE search){
     for(SFL_POS_SIZE counter=1; counter<=graph.deg(base); counter++){
         if (graph.head(base, counter)==search)
             return counter;
@@ -134,6 +333,371 @@ void update_edges(const SFLGraph &graph, annotated_edges_t &annotated, const RSB
 */
 annotated_edges_t annotate_edges(const SFLGraph &graph, const RSBitmap &removednodes=null_bitmap);
 
+//! edge positions without payload
+/*! \typedef edge_layout_t
+    SegmentedArray with one segment per node, get_pos(node, edge) is the position of an edge
+    in annotated_edges_t and in every bitmap stored in its layout.
+*/
+typedef SegmentedArray<> edge_layout_t;
+
+//! edge layout of a graph
+/*! \param graph Graph object
+    \return edge_layout_t with the degrees of graph, O(n+m) bits
+*/
+edge_layout_t edge_layout(const SFLGraph &graph);
+
+//! spanning forest of the depth-first-search
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \return static RSBitmap in the layout of annotated (annotated.get_pos) with both directions of every tree edge set
+*/
+const RSBitmap spanning_forest(const SFLGraph &graph, const annotated_edges_t &annotated);
+
+//! rooted spanning forest in CSR layout
+/*! \class ForestCSR
+    Stores the parent of every node and the children of every node consecutively, all in BitPackedArrays
+    with ceil(log2(n+1)) bits per entry. Every component is rooted in its lowest node.
+*/
+class ForestCSR{
+    //! parent of every node (0 for roots)
+    BitPackedArray parents;
+    //! start of the children of every node in children_, n+1 entries
+    BitPackedArray offsets;
+    //! children of all nodes
+    BitPackedArray children_;
+    // move constructor should be used. To force this, make CopyConstructor private
+    //! Copy Constructor
+    ForestCSR(const ForestCSR& other): parents(other.parents.copy()), offsets(other.offsets.copy()), children_(other.children_.copy()){}
+public:
+    //! Constructor
+    /*! \param graph Graph object
+        \param forest RSBitmap with both directions of every tree edge, in the layout of annotated_edges_t
+        (e.g. from spanning_forest or spanning_forest_parallel), its size is checked
+        Uses a breadth-first-search with the children array as queue, so no word sized temporaries.
+    */
+    ForestCSR(const SFLGraph &graph, const RSBitmap &forest);
+    //! Move Constructor
+    ForestCSR(ForestCSR&&) = default;
+    //! Move assignment
+    ForestCSR& operator=(ForestCSR&&) = default;
+    //! explicit copy ForestCSR.
+    /*!
+        \return copy
+    */
+    inline ForestCSR copy() const{
+        // const attribute of function prevents move constructor
+        return ForestCSR(*this);
+    }
+    //! parent of node
+    /*! \param node node
+        \return parent or 0 for roots
+    */
+    inline SFL_ID_SIZE parent(const SFL_ID_SIZE node) const{
+        return parents.get(node);
+    }
+    //! amount of children
+    /*! \param node node
+        \return amount of children
+    */
+    inline uint64_t children(const SFL_ID_SIZE node) const{
+        return offsets.get(node+1)-offsets.get(node);
+    }
+    //! child of node
+    /*! \param node node
+        \param pos 1-based position in the children of node
+        \return child
+    */
+    inline SFL_ID_SIZE child(const SFL_ID_SIZE node, const uint64_t pos) const{
+        SFLCHECK(pos>0 && pos<=children(node))
+        return children_.get(offsets.get(node)+pos);
+    }
+    //! used memory by component
+    /*! \return SpaceReport with parents, offsets and children
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        report.add("parents", parents.space_report());
+        report.add("offsets", offsets.space_report());
+        report.add("children", children_.space_report());
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
+};
+
+//! space summary of a structure relative to the graph size
+/*! \struct space_summary
+*/
+struct space_summary{
+    //! used memory by component
+    SpaceReport report;
+    //! total bytes
+    uint64_t bytes=0;
+    //! bits per node
+    double bits_per_node=0;
+    //! bits per (undirected) edge
+    double bits_per_edge=0;
+};
+
+//! space summary of annotated edges
+/*! \param graph Graph object
+    \param annotated annotated_edges, e.g. from annotate_edges
+    \return space_summary of annotated
+*/
+space_summary annotation_space(const SFLGraph &graph, const annotated_edges_t &annotated);
+
+//! Connected Components
+/*! \param graph Graph object
+    \param output_func function which takes node, is it a new component
+    \param removednodes RSBitmap with removed nodes
+    \return amount of components
+    Components are reported in the order of their lowest node.
+*/
+uint64_t connected_components(const SFLGraph &graph, std::function<void (SFL_ID_SIZE, bool)>output_func, const RSBitmap &removednodes=null_bitmap);
+//! Connected Components as compact labels
+/*! \param graph Graph object
+    \param removednodes RSBitmap with removed nodes
+    \return BitPackedArray with the 1-based component of every node (0 for removed nodes)
+    The labels use ceil(log2(#components+1)) bits. Requires two depth-first-searches, the first one counts the components.
+*/
+const BitPackedArray connected_components(const SFLGraph &graph, const RSBitmap &removednodes=null_bitmap);
+
+//! hooks of one analysis for a fused traversal
+/*! \struct dfs_visitor
+    Hooks have the same signatures as in dfs. Visitors with the same pass share one depth-first-search,
+    a higher pass is required if an analysis depends on results of a lower pass.
+*/
+struct dfs_visitor{
+    //! prexplore hook, false for an edge hides it from later visitors and the search
+    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> preexplore;
+    //! postexplore hook
+    std::function<void (SFL_ID_SIZE, SFL_ID_SIZE, uint8_t)> postexplore;
+    //! preprocess hook, false for a node hides it from later visitors and the search
+    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> preprocess;
+    //! postprocess hook
+    std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> postprocess;
+    //! called before the search of the pass
+    std::function<void ()> prepare;
+    //! called after the search of the pass
+    std::function<void ()> finish;
+    //! pass of the visitor, starting with 0
+    uint8_t pass=0;
+};
+
+//! result of a fused traversal
+/*! \struct fused_report
+*/
+struct fused_report{
+    //! amount of registered analyses
+    uint64_t analyses=0;
+    //! amount of depth-first-searches executed
+    uint64_t passes=0;
+    //! depth-first-searches saved compared to one search per analysis
+    uint64_t passes_saved=0;
+};
+
+//! runs several analyses with as few depth-first-searches as possible
+/*! \class FusedTraversal
+    Visitors are grouped by pass and every pass executes one depth-first-search.
+    Hooks of a pass are called in registration order. If a preexplore or preprocess hook returns false,
+    the later visitors don't see the edge or node and the search handles it as if a single dfs hook returned false.
+*/
+class FusedTraversal{
+    //! registered visitors
+    std::vector<dfs_visitor> visitors;
+    //! execute all passes
+    fused_report _run(const SFLGraph &graph, const annotated_edges_t *annotated);
+public:
+    //! register an analysis
+    /*! \param visitor hooks of the analysis
+    */
+    void add(dfs_visitor visitor);
+    //! amount of registered analyses
+    /*! \return amount of analyses
+    */
+    inline uint64_t analyses() const noexcept{return visitors.size();}
+    //! execute all analyses with the stack based search
+    /*! \param graph Graph object
+        \return fused_report
+    */
+    fused_report run(const SFLGraph &graph);
+    //! execute all analyses with the annotated search (faster version)
+    /*! \param graph Graph object
+        \param annotated annotated array containing correct parents till current node (e.g. updated by annotate_visitor)
+        \return fused_report
+    */
+    fused_report run(const SFLGraph &graph, const annotated_edges_t &annotated);
+};
+
+//! visitor setting parents and backlinks of annotated (pass 0)
+/*! \param graph Graph object
+    \param annotated annotated_edges to update, requires run with the annotated search
+    \param removednodes RSBitmap with removed nodes
+    \return dfs_visitor
+*/
+dfs_visitor annotate_visitor(const SFLGraph &graph, annotated_edges_t &annotated, const RSBitmap &removednodes=null_bitmap);
+
+//! visitor setting the edge marks of annotated (pass 1)
+/*! \param graph Graph object
+    \param annotated annotated_edges with parents and backlinks (e.g. from annotate_visitor)
+    \param update_object marks to update
+    \param removednodes nodes to ignore, has to match the ones given to annotate_visitor
+    \param pass pass of the visitor
+    \return dfs_visitor
+*/
+dfs_visitor mark_visitor(const SFLGraph &graph, const annotated_edges_t &annotated, marked_edges_t &update_object, const RSBitmap &removednodes=null_bitmap, const uint8_t pass=1);
+
+//! chain of a chain decomposition
+/*! \struct dfs_chain
+    Chains are enumerated like the marks: nodes in preorder, back edges of a node in the order of its edges.
+    A chain starts with a back edge at its first node (the ancestor end) and continues on tree edges upwards
+    from the descendant until it reaches a node of an earlier chain. The first chain of a component ends at
+    its first node, so it is a cycle. Edges in no chain are bridges.
+*/
+struct dfs_chain{
+    //! first node, ancestor end of the back edge
+    SFL_ID_SIZE node=0;
+    //! position of the back edge at node
+    SFL_POS_SIZE edge=0;
+    //! last node, equals node for cycles
+    SFL_ID_SIZE end=0;
+    //! amount of edges, the back edge and length-1 tree edges
+    uint64_t length=0;
+    //! check for cycles
+    /*! \return if the chain ends at its first node
+    */
+    inline bool cycle() const noexcept{return node==end;}
+};
+
+//! visitor enumerating the chain decomposition (Schmidt)
+/*! \param graph Graph object
+    \param annotated annotated_edges with parents and backlinks (e.g. from annotate_visitor)
+    \param output_func function which takes every chain
+    \param pass pass of the visitor
+    \return dfs_visitor
+    Uses one bit per node for the nodes already in a chain. Can share a pass with mark_visitor.
+*/
+dfs_visitor chain_visitor(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (const dfs_chain&)> output_func, const uint8_t pass=1);
+
+//! chain decomposition
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \param output_func function which takes every chain
+    \return amount of chains
+*/
+uint64_t chain_decomposition(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (const dfs_chain&)> output_func);
+//! chain decomposition
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \return vector with the start edge and length of every chain
+*/
+const std::vector<dfs_chain> chain_decomposition(const SFLGraph &graph, const annotated_edges_t &annotated);
+
+//! edges of a chain
+/*! \param graph Graph object
+    \param annotated annotated_edges used for the decomposition
+    \param chain chain from chain_decomposition
+    \param output_func function which takes node and edge position of every edge in chain order
+*/
+void chain_edges(const SFLGraph &graph, const annotated_edges_t &annotated, const dfs_chain &chain, std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> output_func);
+
+//! connectivity certificate from a chain decomposition
+/*! \struct connectivity_certificate
+    The chains certify a positive answer: they form an ear decomposition (2-edge-connected) where
+    only the first chain is a cycle (2-vertex-connected). A negative answer is certified by a bridge or a cut vertex.
+*/
+struct connectivity_certificate{
+    //! amount of nodes (without removed nodes)
+    SFL_ID_SIZE nodes=0;
+    //! amount of connected components
+    uint64_t components=0;
+    //! amount of chains
+    uint64_t chains=0;
+    //! amount of chains which are cycles
+    uint64_t cycles=0;
+    //! amount of bridges
+    uint64_t bridges=0;
+    //! node of a bridge (0 if there is none)
+    SFL_ID_SIZE bridge_node=0;
+    //! position of the bridge at bridge_node
+    SFL_POS_SIZE bridge_edge=0;
+    //! a cut vertex (0 if there is none)
+    SFL_ID_SIZE cut_vertex=0;
+    //! graph is connected, has at least 2 nodes and no bridge
+    bool two_edge_connected=false;
+    //! graph is 2-edge-connected and has no cut vertex
+    bool two_vertex_connected=false;
+};
+
+//! 2-edge and 2-vertex connectivity from one chain decomposition
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \param removednodes RSBitmap with removed nodes (requires updated annotated_edges) (experimental!)
+    \return connectivity_certificate
+    A node is a cut vertex if it is the first node of a cycle which isn't the first chain of its component
+    or if it is the end of a bridge with other edges.
+*/
+connectivity_certificate chain_certificate(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes=null_bitmap);
+
+//! open ear decomposition of a 2-vertex-connected graph
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \param output_func function which takes every ear
+    \return amount of ears
+    The chains of chain_decomposition in their order: the first ear is a cycle, every later ear is a path
+    between two nodes of earlier ears. Throws if the graph isn't 2-vertex-connected (checked with chain_certificate).
+*/
+uint64_t open_ear_decomposition(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (const dfs_chain&)> output_func);
+
+//! st-numbering of a 2-vertex-connected graph
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \return BitPackedArray with the st-number of every node
+    s is the root of the depth-first-search and t its only child, so s gets 1 and t gets n.
+    Every other node has a neighbor with a lower and one with a higher number.
+    Two searches over annotated (Tarjan): the first one computes preorder numbers and low points,
+    the second one inserts the nodes in preorder into a list next to their parent.
+    Uses four arrays with ceil(log2(n+1)) bits per node. Throws if the graph isn't 2-vertex-connected.
+*/
+const BitPackedArray st_numbering(const SFLGraph &graph, const annotated_edges_t &annotated);
+
+//! degree statistics of the visited nodes
+/*! \struct degree_stats
+*/
+struct degree_stats{
+    //! amount of nodes
+    SFL_ID_SIZE nodes=0;
+    //! amount of nodes without edges
+    SFL_ID_SIZE isolated=0;
+    //! minimal degree
+    SFL_POS_SIZE min_deg=0;
+    //! maximal degree
+    SFL_POS_SIZE max_deg=0;
+    //! sum of all degrees
+    uint64_t sum_deg=0;
+};
+
+//! visitor collecting degree statistics
+/*! \param stats degree_stats object to update
+    \param pass pass of the visitor
+    \return dfs_visitor
+*/
+dfs_visitor degree_visitor(degree_stats &stats, const uint8_t pass=0);
+
+//! visitor for connected components
+/*! \param components counter which is increased for every component
+    \param output_func function which takes node, is it a new component
+    \param removednodes RSBitmap with removed nodes
+    \param pass pass of the visitor
+    \return dfs_visitor
+    Requires a pass in which no earlier visitor rejects nodes in the middle of a tree (mark_visitor does).
+*/
+dfs_visitor components_visitor(uint64_t &components, std::function<void (SFL_ID_SIZE, bool)>output_func, const RSBitmap &removednodes=null_bitmap, const uint8_t pass=0);
+
 //! cutvertices
 /*! \param graph Graph object
     \param annotated cached annotated_edges result object
@@ -157,5 +721,274 @@ void biconnected_components(const SFLGraph &graph, const annotated_edges_t &anno
 */
 const std::vector<std::vector<SFL_ID_SIZE>> biconnected_components(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes=null_bitmap);
 
+//! Bi-Connected Components as compact labels
+/*! \class BlockLabels
+    Every node of a block except its top (a cut vertex or root) belongs to the block over its parent edge.
+    This holds for every rooted spanning tree, and the tops only depend on the roots.
+    This block is stored per node in a BitPackedArray with ceil(log2(#blocks+1)) bits.
+    The blocks a node is the top of get consecutive ids, so a SegmentedArray with one segment per node
+    stores them without any payload: the i-th block of a top is its i-th array position.
+    Bridges are not blocks and get the label 0.
+*/
+class BlockLabels{
+    //! block over the parent edge of every node (0 for roots, bridges and removed nodes)
+    BitPackedArray labels;
+    //! blocks of tops, the array positions are the block ids
+    SegmentedArray<> tops;
+    // move constructor should be used. To force this, make CopyConstructor private
+    //! Copy Constructor
+    BlockLabels(const BlockLabels& other): labels(other.labels.copy()), tops(other.tops.copy()){}
+public:
+    //! Constructor
+    /*! \param labels_ block over the parent edge of every node
+        \param tops_ one segment per node with the amount of blocks the node is the top of
+        Use biconnected_labels to create it.
+    */
+    BlockLabels(BitPackedArray &&labels_, SegmentedArray<> &&tops_): labels(std::move(labels_)), tops(std::move(tops_)){}
+    //! Move Constructor
+    BlockLabels(BlockLabels&&) = default;
+    //! Move assignment
+    BlockLabels& operator=(BlockLabels&&) = default;
+    //! explicit copy BlockLabels.
+    /*!
+        \return copy
+    */
+    inline BlockLabels copy() const{
+        // const attribute of function prevents move constructor
+        return BlockLabels(*this);
+    }
+    //! amount of blocks
+    /*! \return amount of blocks (without bridges)
+    */
+    inline uint64_t blocks() const noexcept{
+        return tops.size();
+    }
+    //! block of a node which isn't its top
+    /*! \param node node
+        \return block over the parent edge or 0
+    */
+    inline uint64_t block(const SFL_ID_SIZE node) const{
+        return labels.get(node);
+    }
+    //! amount of blocks node is the top of
+    /*! \param node node
+        \return amount of blocks, more than 0 only for cut vertices and roots
+    */
+    inline uint64_t top_blocks(const SFL_ID_SIZE node) const{
+        return tops.segment_size(node);
+    }
+    //! block node is the top of
+    /*! \param node node
+        \param pos 1-based position in the blocks of node
+        \return block or 0 if pos is too big
+    */
+    inline uint64_t top_block(const SFL_ID_SIZE node, const uint64_t pos) const{
+        return tops.get_pos(node, pos);
+    }
+    //! check block membership
+    /*! \param node node
+        \param block block
+        \return if node belongs to the block
+    */
+    bool contains(const SFL_ID_SIZE node, const uint64_t block) const;
+    //! block of an edge
+    /*! \param graph Graph object
+        \param node node
+        \param edge edge of node
+        \return block containing the edge, 0 for bridges
+    */
+    uint64_t block_of_edge(const SFLGraph &graph, const SFL_ID_SIZE node, const SFL_POS_SIZE edge) const;
+    //! used memory by component
+    /*! \return SpaceReport with labels and tops
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        report.add("labels", labels.space_report());
+        report.add("tops", tops.space_report());
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
+};
+
+//! Bi-Connected Components as compact labels
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \param removednodes RSBitmap with removed nodes (requires updated annotated_edges) (experimental!)
+    \return BlockLabels
+    Blocks are numbered in the order of their tops. Requires O(n+m) time and no per block allocations.
+*/
+const BlockLabels biconnected_labels(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes=null_bitmap);
+
+//! Blocks and cutvertices under edge insertions
+/*! \class IncrementalBlocks
+    Keeps a rooted spanning forest (initially the depth-first-search forest) and a union-find over the
+    tree edges, every tree edge is identified with the node below it. Inserting an edge inside a tree
+    merges the blocks on the tree path between its endpoints, so only this path is walked (like mark_parents).
+    An edge between two trees is a bridge, the tree with the shorter walked path is rerooted at its endpoint.
+    The amount of blocks (bridges included) incident to a node is stored per node, a node is a cutvertex
+    if it is at least 2. All arrays are BitPackedArrays with ceil(log2(n+1)) bits per entry.
+    The amount of nodes is fixed.
+*/
+class IncrementalBlocks{
+    //! parent of every node in the spanning forest (0 for roots)
+    BitPackedArray parents;
+    //! union-find element of the parent edge of every node, the elements of roots are unused own sets
+    BitPackedArray edge_elements;
+    //! union-find parent array, every set is represented by its lowest element
+    BitPackedArray sets;
+    //! amount of blocks incident to every node
+    BitPackedArray incident;
+    //! union-find elements which are bridges
+    RSBitmap bridges;
+    //! nodes visited by the current path search, empty between insertions
+    RSBitmap visited;
+    //! amount of cutvertices
+    uint64_t cutvertices_=0;
+    //! amount of blocks (without bridges)
+    uint64_t blocks_=0;
+    // move constructor should be used. To force this, make CopyConstructor private
+    //! Copy Constructor
+    IncrementalBlocks(const IncrementalBlocks& other);
+    //! find representative with path halving
+    uint64_t _find(uint64_t elem);
+    //! unite two representatives
+    uint64_t _link(const uint64_t root1, const uint64_t root2);
+    //! change the amount of incident blocks of a node
+    void _add_incident(const SFL_ID_SIZE node, const int64_t diff);
+    //! merge the tree edges from start up to (without) stop
+    uint64_t _merge_path(const SFL_ID_SIZE start, const SFL_ID_SIZE stop, uint64_t &nonbridges);
+public:
+    //! Constructor
+    /*! \param graph Graph object
+        \param annotated cached annotated_edges result object
+        Uses the parent edges and marks, requires O(n+m) time.
+    */
+    IncrementalBlocks(const SFLGraph &graph, const annotated_edges_t &annotated);
+    //! Move Constructor
+    IncrementalBlocks(IncrementalBlocks&&) = default;
+    //! Move assignment
+    IncrementalBlocks& operator=(IncrementalBlocks&&) = default;
+    //! explicit copy IncrementalBlocks.
+    /*!
+        \return copy
+    */
+    inline IncrementalBlocks copy() const{
+        // const attribute of function prevents move constructor
+        return IncrementalBlocks(*this);
+    }
+    //! amount of nodes
+    /*! \return amount of nodes
+    */
+    inline SFL_ID_SIZE n() const noexcept{
+        return parents.n();
+    }
+    //! insert edge
+    /*! \param node1 first node
+        \param node2 second node
+        Call it additionally to SFLGraph::add_edge. Takes time linear in the length of the tree path
+        between the nodes (with inverse Ackermann factor), or in their depths if they are in different trees.
+    */
+    void insert(const SFL_ID_SIZE node1, const SFL_ID_SIZE node2);
+    //! parent in the spanning forest
+    /*! \param node node
+        \return parent or 0 for roots
+    */
+    inline SFL_ID_SIZE parent(const SFL_ID_SIZE node) const{
+        return parents.get(node);
+    }
+    //! block of the parent edge
+    /*! \param node node
+        \return representative of the block containing the edge to parent(node), 0 for roots and bridges
+        Representatives change when blocks are merged.
+    */
+    uint64_t block(const SFL_ID_SIZE node);
+    //! check cutvertex
+    /*! \param node node
+        \return if node is a cutvertex
+    */
+    inline bool is_cutvertex(const SFL_ID_SIZE node) const{
+        return incident.get(node)>=2;
+    }
+    //! amount of cutvertices
+    /*! \return amount of cutvertices
+    */
+    inline uint64_t cutvertex_count() const noexcept{
+        return cutvertices_;
+    }
+    //! amount of blocks
+    /*! \return amount of blocks (without bridges)
+    */
+    inline uint64_t blocks() const noexcept{
+        return blocks_;
+    }
+    //! cutvertices as bitmap
+    /*! \return static RSBitmap with the cutvertices, same as the cutvertices function
+    */
+    const RSBitmap cutvertices() const;
+    //! used memory by component
+    /*! \return SpaceReport with all arrays
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        report.add("parents", parents.space_report());
+        report.add("edge_elements", edge_elements.space_report());
+        report.add("sets", sets.space_report());
+        report.add("incident", incident.space_report());
+        report.add("bridges", bridges.space_report());
+        report.add("visited", visited.space_report());
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
+};
+
+//! outerplanarity of every block
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \param output_func function which takes the 1-based block (in the order of biconnected_components) and if it is outerplanar
+    \param removednodes RSBitmap with removed nodes (requires updated annotated_edges) (experimental!)
+    \return amount of blocks which aren't outerplanar
+    Blocks with more than 2k-3 edges for k nodes are rejected directly, the others are reduced by
+    removing nodes of degree 2 (Mitchell). Linear time, the working space is one word per node plus
+    O(k) words for the current block.
+*/
+uint64_t outerplanar_blocks(const SFLGraph &graph, const annotated_edges_t &annotated, std::function<void (uint64_t, bool)>output_func, const RSBitmap &removednodes=null_bitmap);
+//! outerplanarity test
+/*! \param graph Graph object
+    \param annotated cached annotated_edges result object
+    \param removednodes RSBitmap with removed nodes (requires updated annotated_edges) (experimental!)
+    \return if the graph is outerplanar (all blocks are outerplanar)
+    Stops reducing blocks after the first failure.
+*/
+bool is_outerplanar(const SFLGraph &graph, const annotated_edges_t &annotated, const RSBitmap &removednodes=null_bitmap);
+
+
+//! cutvertices of a relabeled graph
+/*! \param relabeled RelabeledGraph object
+    \param annotated cached annotated_edges result object of relabeled.graph()
+    \return RSBitmap with cutvertices (original ids)
+*/
+const RSBitmap cutvertices(const RelabeledGraph &relabeled, const annotated_edges_t &annotated);
+//! Bi-Connected Components of a relabeled graph
+/*! \param relabeled RelabeledGraph object
+    \param annotated cached annotated_edges result object of relabeled.graph()
+    \param output_func function which takes node (original id), is it a new component
+*/
+void biconnected_components(const RelabeledGraph &relabeled, const annotated_edges_t &annotated, std::function<void (SFL_ID_SIZE, bool)>output_func);
+//! Bi-Connected Components of a relabeled graph
+/*! \param relabeled RelabeledGraph object
+    \param annotated cached annotated_edges result object of relabeled.graph()
+    \return vector with twice connected components (original ids)
+*/
+const std::vector<std::vector<SFL_ID_SIZE>> biconnected_components(const RelabeledGraph &relabeled, const annotated_edges_t &annotated);
 
 #endif
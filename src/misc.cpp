@@ -3,6 +3,22 @@
 
 #include <cmath>
 
+void SpaceReport::add(const std::string &name, const uint64_t bytes){
+    components.emplace_back(name, bytes);
+}
+
+void SpaceReport::add(const std::string &prefix, const SpaceReport &other){
+    for(const auto &component: other.components)
+        components.emplace_back(prefix+"."+component.first, component.second);
+}
+
+uint64_t SpaceReport::total() const noexcept{
+    uint64_t bytes=0;
+    for(const auto &component: components)
+        bytes += component.second;
+    return bytes;
+}
+
 uint64_t RSBitmap::calc_blocks(uint64_t nbits) noexcept {
     if (nbits==0)
         return 0;
@@ -20,7 +36,7 @@ RSBitmap::RSBitmap(const uint64_t nbits) : nbits_(nbits),
     if(n()==0)
         return;
     this->array = new uint64_t[blocks()];
-    this->cdarray = new ConstTimeArray<uint32_t>(amount_slates, 0);
+    this->cdarray = new InPlaceConstTimeArray<uint32_t>(amount_slates, 0);
     assert(find_slate(nbits)==cdarray->n());
     // cdarray should be active
     assert(this->cdarray!=nullptr && this->rsarray==nullptr);
@@ -37,7 +53,7 @@ amount_1(other.amount_1)
     this->array = new uint64_t[blocks()];
     std::copy(other.array, other.array+blocks(), this->array);
     if (other.cdarray){
-        this->cdarray = new ConstTimeArray<uint32_t>(other.cdarray->copy());
+        this->cdarray = new InPlaceConstTimeArray<uint32_t>(other.cdarray->copy());
     }
     if (other.rsarray){
         this->rsarray = new rank9sel(array, blocks()*64);
@@ -123,16 +139,17 @@ bool RSBitmap::get(const uint64_t pos) const{
 // intern
 void RSBitmap::_init_slate(const uint64_t slate){
     assert(slate>0);
-    if (cdarray->is_init(slate))
+    if (cdarray->get(slate)!=0)
         return;
+    SFL_COUNT(counter_init_slate)
     uint64_t base = (slate-1)*size_slate;
     // slate can have not full size
     uint64_t limiter = std::min(base+size_slate, blocks());
     for(uint64_t counter=base; counter<limiter; counter++){
         array[counter] = 0;
     }
-    // mark initialized
-    cdarray->set(slate, 0);
+    // mark initialized, counters are stored +1
+    cdarray->set(slate, 1);
 }
 
 void RSBitmap::set(const uint64_t pos, const bool state){
@@ -154,10 +171,10 @@ void RSBitmap::set(const uint64_t pos, const bool state){
 
     if (old_state && !state){
         --amount_1;
-        --cdarray->ref(slate);
+        _add_slate_ones(slate, -1);
     } else if (!old_state && state){
         ++amount_1;
-        ++cdarray->ref(slate);
+        _add_slate_ones(slate, 1);
     }
 }
 void RSBitmap::flip(const uint64_t pos){
@@ -176,10 +193,10 @@ void RSBitmap::flip(const uint64_t pos){
     // with flip old state is known
     if (!new_state){
         --amount_1;
-        --cdarray->ref(slate);
+        _add_slate_ones(slate, -1);
     } else if (new_state){
         ++amount_1;
-        ++cdarray->ref(slate);
+        _add_slate_ones(slate, 1);
     }
 }
 
@@ -238,7 +255,7 @@ void RSBitmap::set_n(const uint64_t pos, const uint8_t nblock, const uint64_t va
 
     array[start/64] = (value<<start_rest) | (array[start/64]&bitm1);
     diff=__builtin_popcountll(value<<start_rest)-__builtin_popcountll(old_value<<start_rest);
-    cdarray->ref(slate)+=diff;
+    _add_slate_ones(slate, diff);
     amount_1+=diff;
     if (slate!=find_slate(end+1)){
         this->_init_slate(slate+1);
@@ -246,11 +263,26 @@ void RSBitmap::set_n(const uint64_t pos, const uint8_t nblock, const uint64_t va
         uint64_t bitm_next=~((-1ull)>>(start_rest-1));
         array[end/64] = (value>>next_rest)|(array[end/64]&(bitm_next));
         diff = __builtin_popcountll(value>>next_rest)-__builtin_popcountll(old_value>>next_rest);
-        cdarray->ref(slate+1)+=diff;
+        _add_slate_ones(slate+1, diff);
         amount_1+=diff;
     }
 }
 
+SpaceReport RSBitmap::space_report() const{
+    SpaceReport report;
+    if (n()==0)
+        return report;
+    report.add("array", blocks()*sizeof(uint64_t));
+    // exactly one of these structures is allocated
+    if (this->cdarray){
+        report.add("slates", sizeof(InPlaceConstTimeArray<uint32_t>));
+        report.add("slates", this->cdarray->space_report());
+    }
+    if (this->rsarray)
+        report.add("rank9sel", this->rsarray->bit_count()/8);
+    return report;
+}
+
 void RSBitmap::make_static(){
     if(n()==0)
         return;
@@ -265,14 +297,51 @@ void RSBitmap::make_static(){
     delete this->cdarray;
     this->cdarray=nullptr;
     assert(this->rsarray==nullptr);
+    SFL_COUNT(counter_make_static)
     assert(this->array!=nullptr);
     this->rsarray = new rank9sel(this->array, blocks()*64);
 
     assert(this->cdarray==nullptr && this->rsarray!=nullptr);
 }
 
+void RSBitmap::make_dynamic(){
+    if(n()==0)
+        return;
+    // already dynamic
+    if(!this->rsarray)
+        return;
+    delete this->rsarray;
+    this->rsarray=nullptr;
+    this->cdarray = new InPlaceConstTimeArray<uint32_t>(amount_slates, 0);
+    for(uint64_t slate=1; slate<=amount_slates; slate++){
+        uint64_t base = (slate-1)*size_slate, ones=0;
+        uint64_t limiter = std::min(base+size_slate, blocks());
+        for(uint64_t counter=base; counter<limiter; counter++){
+            ones += __builtin_popcountll(array[counter]);
+        }
+        cdarray->set(slate, static_cast<uint32_t>(ones+1));
+    }
+    assert(this->cdarray!=nullptr && this->rsarray==nullptr);
+}
+
+void RSBitmap::clear(){
+    if(n()==0)
+        return;
+    amount_1=0;
+    if(this->rsarray){
+        delete this->rsarray;
+        this->rsarray=nullptr;
+        this->cdarray = new InPlaceConstTimeArray<uint32_t>(amount_slates, 0);
+    } else {
+        // slates are initialized on the next write
+        this->cdarray->clear();
+    }
+    assert(this->cdarray!=nullptr && this->rsarray==nullptr);
+}
+
 uint64_t RSBitmap::rank(const uint64_t pos) const{
     SFLCHECK(pos!=0)
+    SFL_COUNT(counter_rank)
     if(pos>n() || amount_1==0)
         return amount_1;
     if(rsarray){
@@ -280,7 +349,7 @@ uint64_t RSBitmap::rank(const uint64_t pos) const{
     }
     uint64_t rank=0, ipos=1, limiter=find_slate(pos), _size=size_slate*64;
     for(uint64_t counter=1; counter<limiter; counter++){
-        rank+=cdarray->get(counter);
+        rank+=_slate_ones(counter);
         ipos+=_size;
     }
     assert(ipos<=n());
@@ -294,6 +363,7 @@ uint64_t RSBitmap::rank(const uint64_t pos) const{
     return rank;
 }
 uint64_t RSBitmap::select(const uint64_t rank) const{
+    SFL_COUNT(counter_select)
     if(rank>=amount_1){
         return 0;
     }
@@ -302,11 +372,11 @@ uint64_t RSBitmap::select(const uint64_t rank) const{
     }
 
     uint64_t _rank=rank+1, ipos=1, ranktmp, _size=size_slate*64;
-    ranktmp = cdarray->get(find_slate(ipos));
+    ranktmp = _slate_ones(find_slate(ipos));
     while(ranktmp<_rank){
         _rank-=ranktmp;
         ipos+=_size;
-        ranktmp = cdarray->get(find_slate(ipos));
+        ranktmp = _slate_ones(find_slate(ipos));
     }
     // should be at slate begin
     assert((ipos%_size)==1);
@@ -327,6 +397,7 @@ uint64_t RSBitmap::select(const uint64_t rank) const{
 
 
 uint64_t RSBitmap::next_one(const uint64_t pos) const{
+    SFL_COUNT(counter_next_one)
     if(pos>n())
         return 0;
     if(rsarray){
@@ -338,7 +409,7 @@ uint64_t RSBitmap::next_one(const uint64_t pos) const{
 
     while (ipos<=n() && !get(ipos)){
         assert(slate==find_slate(ipos));
-        if(cdarray->get(slate)==0){
+        if(_slate_ones(slate)==0){
             // start: (ipos%_size)!=1
             // align to slate
             // 1 causes wrap to next slate (next to alignment)
@@ -384,6 +455,78 @@ uint64_t RSBitmap::next_one_n(const uint64_t pos, const uint8_t nblock) const{
         return ((sel-1)/nblock)+1;
 }
 
+BitPackedArray::BitPackedArray(const uint64_t n, const uint8_t width): n_(n),
+width_(width),
+mask_(width>=64 ? -1ull : (1ull<<width)-1){
+    SFLCHECK(width>0 && width<=64)
+    if(blocks()==0)
+        return;
+    // value initialized => 0
+    this->array = new uint64_t[blocks()]();
+}
+
+BitPackedArray::BitPackedArray(const BitPackedArray& other): n_(other.n_),
+width_(other.width_),
+mask_(other.mask_){
+    if(blocks()==0)
+        return;
+    this->array = new uint64_t[blocks()];
+    std::copy(other.array, other.array+blocks(), this->array);
+}
+
+BitPackedArray::BitPackedArray(BitPackedArray&& other) noexcept: n_(other.n_),
+width_(other.width_),
+mask_(other.mask_){
+    this->array=other.array;
+    other.array=nullptr;
+}
+
+BitPackedArray& BitPackedArray::operator=(BitPackedArray&& other) noexcept{
+    if (this != &other){
+        if(this->array)
+            delete[] this->array;
+        n_ = other.n_;
+        width_ = other.width_;
+        mask_ = other.mask_;
+        this->array=other.array;
+        other.array=nullptr;
+    }
+    return *this;
+}
+
+BitPackedArray::~BitPackedArray(){
+    if(array)
+        delete[] array;
+}
+
+uint8_t BitPackedArray::calc_width(const uint64_t max_value) noexcept{
+    if (max_value==0)
+        return 1;
+    return 64-__builtin_clzll(max_value);
+}
+
+PackedSpinStack::PackedSpinStack(const uint64_t size, const SFL_ID_SIZE max_node, const SFL_POS_SIZE max_edge):
+mask_(spin_buffer_size(size)-1),
+node_width_(BitPackedArray::calc_width(max_node)),
+array(mask_+1, std::min(64, BitPackedArray::calc_width(max_node)+BitPackedArray::calc_width(max_edge))),
+n(size){
+    assert(this->n>0);
+    SFLCHECK(fits(max_node, max_edge))
+}
+
+PackedSpinStack::PackedSpinStack(PackedSpinStack&& other) noexcept: top_(other.top_),
+bottom_(other.bottom_),
+mask_(other.mask_),
+node_width_(other.node_width_),
+array(std::move(other.array)),
+n(other.n){
+    other.top_=other.bottom_=0;
+}
+
+bool PackedSpinStack::fits(const SFL_ID_SIZE max_node, const SFL_POS_SIZE max_edge) noexcept{
+    return BitPackedArray::calc_width(max_node)+BitPackedArray::calc_width(max_edge)<=64;
+}
+
 bool ChoiceDictionary::insert(const uint64_t pos){
     // bound checking
     if (pos==0 || pos>capacity())
@@ -7,6 +7,7 @@
 #define spacefmisc
 
 #include "commondefinitions.h"
+#include "counters.hpp"
 
 #include <cstddef>
 #include <vector>
@@ -14,9 +15,35 @@
 #include <utility>
 #include <algorithm>
 #include <type_traits>
+#include <string>
+#include <variant>
 
 class rank9sel;
 
+//! memory usage of a structure broken down by component
+/*! \struct SpaceReport
+    Sizes are in bytes and cover the heap memory owned by a structure, not the object itself.
+    Heap allocated subobjects are listed with their object size and their own components.
+*/
+struct SpaceReport{
+    //! components with name and bytes
+    std::vector<std::pair<std::string, uint64_t>> components;
+    //! add component
+    /*! \param name name of component
+        \param bytes size in bytes
+    */
+    void add(const std::string &name, const uint64_t bytes);
+    //! add all components of a substructure
+    /*! \param prefix name of the substructure, prepended with a dot to all component names
+        \param other report of the substructure
+    */
+    void add(const std::string &prefix, const SpaceReport &other);
+    //! total size
+    /*! \return sum of all components in bytes
+    */
+    uint64_t total() const noexcept;
+};
+
 //! Base type of ConstTimeArray
 /*! \tparam T element type of the array
 */
@@ -47,47 +74,15 @@ public:
     virtual void set(const uint64_t pos, const T obj) = 0;
 };
 
-//! Base type of ConstTimeArrayInitArrImpl
-class ConstTimeInitArr{
-    uint64_t n_=0;
-public:
-    //! Constructor
-    /*! \param n amount of elements
-    */
-    ConstTimeInitArr(uint64_t n): n_(n){}
-    //! Destructor
-    virtual ~ConstTimeInitArr(){};
-    //! Check if position is initialized or return position
-    /*! \param pos position
-        \return position or 0
-    */
-    virtual uint64_t get_pos(const uint64_t pos) const=0;
-    //virtual uint64_t size() const=0;
-    //! update initialization state of slot and return position
-    virtual uint64_t update_arrays(const uint64_t pos)=0;
-    //! explicit copy
-    virtual ConstTimeInitArr* copy() const=0;
-    //! current amount of elements
-    /*! \return current amount of elements
-    */
-    virtual uint64_t size() const noexcept=0;
-    //! maximal amount of elements
-    /*! \return maximal amount of elements (=maximum position)
-    */
-    uint64_t n() const noexcept{
-        return n_;
-    }
-};
-
 //! Constant time allocation helper
 /*! \tparam T Type holding array positions
 */
 template<typename T>
-class ConstTimeInitArrImpl: public ConstTimeInitArr{
-    //! array initialization point->pos
-    T *init_pointers1=nullptr;
-    //! array pos->initialization point
-    T *init_pointers2=nullptr;
+class ConstTimeInitArrImpl{
+    //! maximal amount of elements
+    uint64_t n_=0;
+    //! both pointer arrays in one block, [0, n) initialization point->pos, [n, 2n) pos->initialization point
+    T *init_pointers=nullptr;
     // Amount initialized fields
     uint64_t init_count=0;
 
@@ -96,51 +91,72 @@ class ConstTimeInitArrImpl: public ConstTimeInitArr{
     ConstTimeInitArrImpl(other.n()){
         init_count = other.init_count;
         // copy only size
-        std::copy(other.init_pointers1, other.init_pointers1+size(), this->init_pointers1);
+        std::copy(other.init_pointers, other.init_pointers+size(), this->init_pointers);
         // full size required
-        std::copy(other.init_pointers2, other.init_pointers2+n(), this->init_pointers2);
+        std::copy(other.init_pointers+n(), other.init_pointers+2*n(), this->init_pointers+n());
     }
 public:
     //! Construct n sized array
-    ConstTimeInitArrImpl(uint64_t n) : ConstTimeInitArr(n){
-        if (n>0){
-            this->init_pointers1 = new T[n];
-            this->init_pointers2 = new T[n];
-        }
+    ConstTimeInitArrImpl(uint64_t n) : n_(n){
+        if (n>0)
+            this->init_pointers = new T[2*n];
     }
     //! move Constructor
-    ConstTimeInitArrImpl(ConstTimeInitArrImpl<T>&& other):
-    ConstTimeInitArr(n()),
+    ConstTimeInitArrImpl(ConstTimeInitArrImpl<T>&& other) noexcept:
+    n_(other.n_),
+    init_pointers(other.init_pointers),
     init_count(other.init_count){
-        assert(n()==other.n());
-        assert(init_count==other.init_count);
-        // move array pointers
-        this->init_pointers1=other.init_pointers1;
-        this->init_pointers2=other.init_pointers2;
-        // invalidate old array pointers
-        other.init_pointers1=nullptr;
-        other.init_pointers2=nullptr;
+        // invalidate old array pointer
+        other.init_pointers=nullptr;
+        other.n_=0;
+        other.init_count=0;
+    }
+    //! Move assignment
+    ConstTimeInitArrImpl& operator=(ConstTimeInitArrImpl<T> &&other) noexcept{
+        if (this != &other){
+            if (this->init_pointers)
+                delete[] this->init_pointers;
+            n_ = other.n_;
+            init_pointers = other.init_pointers;
+            init_count = other.init_count;
+            other.init_pointers=nullptr;
+            other.n_=0;
+            other.init_count=0;
+        }
+        return *this;
     }
     ~ConstTimeInitArrImpl(){
-        if(init_pointers1)
-            delete[] init_pointers1;
-        if(init_pointers2)
-            delete[] init_pointers2;
+        if(init_pointers)
+            delete[] init_pointers;
     }
     //! explicit copy
-    ConstTimeInitArr* copy() const{
+    ConstTimeInitArrImpl<T> copy() const{
         // const attribute of function prevents move constructor
-        ConstTimeInitArrImpl* temp;
-        temp = new ConstTimeInitArrImpl<T>(*this);
-        return temp;
+        return ConstTimeInitArrImpl<T>(*this);
     }
 
+    //! maximal amount of elements
+    /*! \return maximal amount of elements (=maximum position)
+    */
+    uint64_t n() const noexcept{
+        return n_;
+    }
     //! current amount of elements
     /*! \return current amount of elements
     */
     uint64_t size() const noexcept {
         return init_count;
     }
+    //! mark all positions uninitialized in constant time
+    void clear() noexcept {
+        init_count = 0;
+    }
+    //! used memory
+    /*! \return bytes of both pointer arrays
+    */
+    uint64_t memory_usage() const noexcept {
+        return 2*n()*sizeof(T);
+    }
 
     //! Check if position is initialized or return position
     /*! \param pos position
@@ -149,8 +165,8 @@ public:
     uint64_t get_pos(const uint64_t pos) const {
         assert(pos>0);
         assert(pos<=n());
-        T rarraypos = init_pointers2[pos-1];
-        if (rarraypos<init_count && init_pointers1[rarraypos]==pos-1)
+        T rarraypos = init_pointers[n_+pos-1];
+        if (rarraypos<init_count && init_pointers[rarraypos]==pos-1)
             return rarraypos+1;
         else{
             return 0;
@@ -164,9 +180,10 @@ public:
         assert(pos>=1);
         uint64_t arrpos = get_pos(pos);
         if (arrpos==0){
+            SFL_COUNT(counter_array_init)
             // save 0-based for optimal usage of storage and e.g. uint8_t
-            init_pointers2[pos-1] = static_cast<T>(init_count);
-            init_pointers1[init_count] = static_cast<T>(pos-1);
+            init_pointers[n_+pos-1] = static_cast<T>(init_count);
+            init_pointers[init_count] = static_cast<T>(pos-1);
             this->init_count++;
             assert(init_count<=n());
             // +1 for 1-based output
@@ -177,6 +194,115 @@ public:
     }
 };
 
+//! Initialization tracking of ConstTimeArray with the smallest fitting position type
+/*!
+    The position type is chosen once in the constructor. Calls dispatch with a switch over the
+    alternatives, so every branch is inlined instead of going through virtual calls.
+*/
+class ConstTimeInitArr{
+    //! empty if n is 0
+    std::variant<std::monostate, ConstTimeInitArrImpl<uint8_t>, ConstTimeInitArrImpl<uint16_t>,
+        ConstTimeInitArrImpl<uint32_t>, ConstTimeInitArrImpl<uint64_t>> impl;
+
+    //! call func with the active ConstTimeInitArrImpl
+    template<typename Func>
+    uint64_t dispatch(Func &&func) const{
+        switch(impl.index()){
+            case 1: return func(*std::get_if<1>(&impl));
+            case 2: return func(*std::get_if<2>(&impl));
+            case 3: return func(*std::get_if<3>(&impl));
+            case 4: return func(*std::get_if<4>(&impl));
+            default: return 0;
+        }
+    }
+    //! call func with the active ConstTimeInitArrImpl
+    template<typename Func>
+    uint64_t dispatch(Func &&func){
+        switch(impl.index()){
+            case 1: return func(*std::get_if<1>(&impl));
+            case 2: return func(*std::get_if<2>(&impl));
+            case 3: return func(*std::get_if<3>(&impl));
+            case 4: return func(*std::get_if<4>(&impl));
+            default: return 0;
+        }
+    }
+    //! empty Constructor
+    ConstTimeInitArr(){}
+public:
+    //! Constructor
+    /*! \param n amount of elements
+    */
+    ConstTimeInitArr(uint64_t n){
+        if (n==0){ // do nothing
+        }else if (n<=UINT8_MAX)
+            impl.emplace<1>(n);
+        else if (n<=UINT16_MAX)
+            impl.emplace<2>(n);
+        else if (n<=UINT32_MAX)
+            impl.emplace<3>(n);
+        else
+            impl.emplace<4>(n);
+    }
+    //! move Constructor
+    ConstTimeInitArr(ConstTimeInitArr&& other) noexcept:
+    impl(std::move(other.impl)){
+        other.impl.emplace<0>();
+    }
+    //! Move assignment
+    ConstTimeInitArr& operator=(ConstTimeInitArr &&other) noexcept{
+        if (this != &other){
+            impl = std::move(other.impl);
+            other.impl.emplace<0>();
+        }
+        return *this;
+    }
+    //! explicit copy
+    ConstTimeInitArr copy() const{
+        ConstTimeInitArr temp;
+        switch(impl.index()){
+            case 1: temp.impl.emplace<1>(std::get_if<1>(&impl)->copy()); break;
+            case 2: temp.impl.emplace<2>(std::get_if<2>(&impl)->copy()); break;
+            case 3: temp.impl.emplace<3>(std::get_if<3>(&impl)->copy()); break;
+            case 4: temp.impl.emplace<4>(std::get_if<4>(&impl)->copy()); break;
+            default: break;
+        }
+        return temp;
+    }
+    //! Check if position is initialized or return position
+    /*! \param pos position
+        \return position or 0
+    */
+    uint64_t get_pos(const uint64_t pos) const{
+        return dispatch([pos](const auto &arrays){return arrays.get_pos(pos);});
+    }
+    //! update initialization state of slot and return position
+    uint64_t update_arrays(const uint64_t pos){
+        return dispatch([pos](auto &arrays){return arrays.update_arrays(pos);});
+    }
+    //! mark all positions uninitialized in constant time
+    void clear(){
+        dispatch([](auto &arrays){arrays.clear(); return 0;});
+    }
+    //! current amount of elements
+    /*! \return current amount of elements
+    */
+    uint64_t size() const noexcept{
+        return dispatch([](const auto &arrays){return arrays.size();});
+    }
+    //! maximal amount of elements
+    /*! \return maximal amount of elements (=maximum position)
+    */
+    uint64_t n() const noexcept{
+        return dispatch([](const auto &arrays){return arrays.n();});
+    }
+    //! used memory
+    /*! \return bytes of both pointer arrays
+    */
+    uint64_t memory_usage() const noexcept{
+        return dispatch([](const auto &arrays){return arrays.memory_usage();});
+    }
+};
+
 //! Constant time array (unspecialized)
 /*! \tparam T element type of the array
 */
@@ -185,64 +311,52 @@ class ConstTimeArray: public BaseConstTimeArray<T>{
     //! array with objects
     T *array=nullptr;
     //! Initialization array
-    ConstTimeInitArr *init=nullptr;
+    ConstTimeInitArr init;
     //! defaultelement
     T defaultelement;
     // can be recursive, don't copy implicitly
     //! Copy constructor
     ConstTimeArray(const ConstTimeArray<T>& other):
-    init(other.init->copy()),
+    init(other.init.copy()),
     defaultelement(other.defaultelement){
-        assert(sizeof(T)*init->n()>0);
-        // allocate but don't initialize => constant time
-        this->array = static_cast<T*>(::operator new(sizeof(T)*this->init->n()));
-        // copy initialized
-        std::copy(other.array, other.array+this->init->size(), this->array);
+        if (this->init.n()>0){
+            // allocate but don't initialize => constant time
+            this->array = static_cast<T*>(::operator new(sizeof(T)*this->init.n()));
+            // copy initialized
+            std::copy(other.array, other.array+this->init.size(), this->array);
+        }
     }
 public:
     //! Constructor
     /*! \param n amount of elements
         \param default_element default element which will be returned or used to initialize. Must be copyable.
     */
-    ConstTimeArray(uint64_t n, const T &default_element): defaultelement(default_element) {
+    ConstTimeArray(uint64_t n, const T &default_element): init(n), defaultelement(default_element) {
         // check if type is compatible. Bad if it uses non trivial destructors
         static_assert(std::is_trivially_destructible<T>::value, "Type is not trivial destructable");
         // Bad if it is not copyable
         static_assert(std::is_copy_constructible<T>::value, "Type is not copyable");
-        // create pointerob_size in size of required integer type
-        if (n==0){ // do nothing
-        }else if (n<=UINT8_MAX)
-            this->init = new ConstTimeInitArrImpl<uint8_t>(n);
-        else if (n<=UINT16_MAX)
-            this->init = new ConstTimeInitArrImpl<uint16_t>(n);
-        else if (n<=UINT32_MAX)
-            this->init = new ConstTimeInitArrImpl<uint32_t>(n);
-        else
-            this->init = new ConstTimeInitArrImpl<uint64_t>(n);
-
-        assert(sizeof(T)*init->n()>0);
-        // allocate but don't initialize => constant time
-        this->array = static_cast<T*>(::operator new(sizeof(T)*n));
+        if (n>0){
+            // allocate but don't initialize => constant time
+            this->array = static_cast<T*>(::operator new(sizeof(T)*n));
+        }
     }
     //! Move Constructor
     /*!
         steal data and pointers, invalidate pointer of the dying instance afterwards
     */
     ConstTimeArray(ConstTimeArray<T>&& other):
+    init(std::move(other.init)),
     defaultelement(other.defaultelement){
         // move array pointers
         this->array=other.array;
-        this->init=other.init;
         // invalidate old array pointers
         other.array=nullptr;
-        other.init=nullptr;
     }
     ~ConstTimeArray() noexcept{
         if(array){
             ::operator delete(this->array);
         }
-        if(init)
-            delete init;
     }
 
     //! Move assignment
@@ -253,15 +367,11 @@ public:
             if (this->array){
                 ::operator delete(this->array);
             }
-            if (this->init){
-                delete this->init;
-            }
             // move array pointers
             this->array=other.array;
-            this->init=other.init;
+            this->init=std::move(other.init);
             // invalidate old array pointers
             other.array=nullptr;
-            other.init=nullptr;
         }
         return *this;
     }
@@ -278,11 +388,32 @@ public:
         // const attribute of function prevents move constructor
         return ConstTimeArray<T>(*this);
     }
+    //! reset all elements to the defaultelement in constant time
+    void clear(){
+        this->init.clear();
+    }
     //! max elements
     /*! \return maximal amount of elements
     */
     uint64_t n() const noexcept{
-        return this->init->n();
+        return this->init.n();
+    }
+    //! used memory by component
+    /*! \return SpaceReport with element array and initialization arrays
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        if (this->array){
+            report.add("array", sizeof(T)*n());
+            report.add("init", this->init.memory_usage());
+        }
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
     }
 
     //! Set element
@@ -294,7 +425,7 @@ public:
         SFLCHECK(pos>0)
         SFLCHECK(pos<=n())
         // use 0 based array
-        array[this->init->update_arrays(pos)-1] = obj;
+        array[this->init.update_arrays(pos)-1] = obj;
     }
     //! Get element or default element, don't initialize
     /*! \param pos position of element
@@ -305,7 +436,7 @@ public:
         SFLCHECK(pos>0)
         if(pos>n())
             return substitute_uninitialized(pos);
-        uint64_t arrpos = this->init->get_pos(pos);
+        uint64_t arrpos = this->init.get_pos(pos);
         if (arrpos>0)
             return array[arrpos-1];
         else{
@@ -321,11 +452,11 @@ public:
         // checks here are important as init is assert only
         SFLCHECK(pos>0)
         SFLCHECK(pos<=n())
-        uint64_t arrpos = this->init->get_pos(pos);
+        uint64_t arrpos = this->init.get_pos(pos);
         if (arrpos!=0)
             return array[arrpos-1];
         else{
-            arrpos = this->init->update_arrays(pos);
+            arrpos = this->init.update_arrays(pos);
             // use 0 based array
             array[arrpos-1] = substitute_uninitialized(pos);
             return array[arrpos-1];
@@ -340,7 +471,264 @@ public:
         // checks here are important as init is assert only
         SFLCHECK(pos>0)
         SFLCHECK(pos<=n())
-        return this->init->get_pos(pos)!=0;
+        return this->init.get_pos(pos)!=0;
+    }
+};
+
+//! Constant time array which keeps its initialization state inside the elements
+/*! \class InPlaceConstTimeArray
+    In-place initializable array after Katoh and Goto. Positions are grouped in blocks of two.
+    Blocks left of the boundary are written, blocks right of it unwritten. A written and an unwritten
+    block pointing at each other with their first element form a chain: the written one counts as
+    uninitialized, the unwritten one as initialized with its first element stored in the second slot of
+    its partner. Besides the elements only the boundary and, for odd n, the last element are stored.
+    \tparam T unsigned integer type, must be able to hold the amount of blocks (n/2)
+    \warning no references to elements, a set can move elements of other blocks
+*/
+template<typename T>
+class InPlaceConstTimeArray: public BaseConstTimeArray<T>{
+    //! array with objects and chain pointers
+    T *array=nullptr;
+    //! amount of elements
+    uint64_t n_=0;
+    //! amount of blocks of two elements
+    uint64_t blocks_=0;
+    //! first unwritten block
+    uint64_t boundary=0;
+    //! defaultelement
+    T defaultelement;
+    //! element n if n is odd
+    T last;
+    //! is last initialized
+    bool last_init=false;
+
+    //! Copy constructor
+    InPlaceConstTimeArray(const InPlaceConstTimeArray<T>& other):
+    InPlaceConstTimeArray(other.n_, other.defaultelement){
+        boundary = other.boundary;
+        last = other.last;
+        last_init = other.last_init;
+        // unwritten blocks can be chained, copy all
+        std::copy(other.array, other.array+2*blocks_, this->array);
+    }
+    //! chained block
+    /*! \param block 0-based block
+        \return 0-based partner block or blocks_ if not chained
+    */
+    inline uint64_t partner(const uint64_t block) const{
+        const uint64_t other = array[2*block];
+        if (block<boundary){
+            if (other>=boundary && other<blocks_ && array[2*other]==block)
+                return other;
+        } else if (other<boundary && array[2*other]==block){
+            return other;
+        }
+        return blocks_;
+    }
+    //! remove a chain a written block forms by accident with its first element
+    /*! \param block 0-based written block
+    */
+    inline void unchain(const uint64_t block){
+        assert(block<boundary);
+        const uint64_t other = array[2*block];
+        // other can't be a real partner as block is written
+        if (other>=boundary && other<blocks_ && array[2*other]==block)
+            array[2*other] = static_cast<T>(other);
+    }
+    //! move boundary one block right
+    /*! \return written block which holds no elements, must be chained or initialized by the caller
+    */
+    uint64_t extend(){
+        assert(boundary<blocks_);
+        const uint64_t block = boundary;
+        const uint64_t other = partner(block);
+        boundary++;
+        if (other==blocks_)
+            return block;
+        // block was initialized with its first element at its partner
+        array[2*block] = array[2*other+1];
+        unchain(block);
+        return other;
+    }
+    //! initialize a written block with default elements
+    /*! \param block 0-based written block
+    */
+    void init_block(const uint64_t block){
+        SFL_COUNT(counter_array_init)
+        array[2*block] = defaultelement;
+        array[2*block+1] = defaultelement;
+    }
+public:
+    //! Constructor
+    /*! \param n amount of elements
+        \param default_element default element which will be returned
+    */
+    InPlaceConstTimeArray(uint64_t n, const T &default_element): n_(n),
+    blocks_(n/2),
+    defaultelement(default_element),
+    last(default_element){
+        static_assert(std::is_unsigned<T>::value, "Type must be an unsigned integer");
+        // blocks are chained by their ids
+        SFLCHECK(blocks_<=static_cast<T>(-1))
+        if (blocks_>0){
+            // allocate but don't initialize => constant time
+            this->array = new T[2*blocks_];
+        }
+    }
+    //! Move Constructor
+    InPlaceConstTimeArray(InPlaceConstTimeArray<T>&& other) noexcept: array(other.array),
+    n_(other.n_),
+    blocks_(other.blocks_),
+    boundary(other.boundary),
+    defaultelement(other.defaultelement),
+    last(other.last),
+    last_init(other.last_init){
+        other.array=nullptr;
+        other.n_=0;
+        other.blocks_=0;
+        other.boundary=0;
+    }
+    //! Move assignment
+    InPlaceConstTimeArray& operator=(InPlaceConstTimeArray<T> &&other) noexcept{
+        if (this != &other){
+            if (this->array)
+                delete[] this->array;
+            array = other.array;
+            n_ = other.n_;
+            blocks_ = other.blocks_;
+            boundary = other.boundary;
+            defaultelement = other.defaultelement;
+            last = other.last;
+            last_init = other.last_init;
+            other.array=nullptr;
+            other.n_=0;
+            other.blocks_=0;
+            other.boundary=0;
+        }
+        return *this;
+    }
+    ~InPlaceConstTimeArray() noexcept{
+        if (array)
+            delete[] array;
+    }
+    //! explicit copy Array.
+    /*!
+        \return copy
+    */
+    InPlaceConstTimeArray<T> copy() const{
+        // const attribute of function prevents move constructor
+        return InPlaceConstTimeArray<T>(*this);
+    }
+    //! reset all elements to the defaultelement in constant time
+    void clear() noexcept{
+        // without written blocks there are no chains
+        boundary = 0;
+        last_init = false;
+    }
+    //! sustitute by defaultelement
+    const T substitute_uninitialized(const uint64_t pos=0) const{
+        return defaultelement;
+    };
+    //! max elements
+    /*! \return maximal amount of elements
+    */
+    uint64_t n() const noexcept{
+        return n_;
+    }
+    //! used memory by component
+    /*! \return SpaceReport with element array
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        if (this->array)
+            report.add("array", 2*blocks_*sizeof(T));
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
+
+    //! Get element or default element
+    /*! \param pos position of element
+        \return element T
+    */
+    const T get(const uint64_t pos) const{
+        SFLCHECK(pos>0)
+        if (pos>n())
+            return substitute_uninitialized(pos);
+        if (pos>2*blocks_)
+            return last_init ? last : substitute_uninitialized(pos);
+        const uint64_t block = (pos-1)/2;
+        const uint64_t other = partner(block);
+        if (block<boundary)
+            return other==blocks_ ? array[pos-1] : substitute_uninitialized(pos);
+        if (other==blocks_)
+            return substitute_uninitialized(pos);
+        // first element is stored at the partner
+        return (pos-1)%2==0 ? array[2*other+1] : array[pos-1];
+    }
+    //! Set element
+    /*! \param pos position of element
+        \param obj object
+    */
+    void set(const uint64_t pos, const T obj){
+        SFLCHECK(pos>0)
+        SFLCHECK(pos<=n())
+        if (pos>2*blocks_){
+            last = obj;
+            last_init = true;
+            return;
+        }
+        const uint64_t block = (pos-1)/2;
+        const uint64_t other = partner(block);
+        if (block>=boundary && other!=blocks_){
+            // initialized unwritten block
+            if ((pos-1)%2==0)
+                array[2*other+1] = obj;
+            else
+                array[pos-1] = obj;
+            return;
+        }
+        if (block>=boundary){
+            // uninitialized unwritten block
+            if (block==boundary){
+                boundary++;
+                init_block(block);
+                array[pos-1] = obj;
+                unchain(block);
+                return;
+            }
+            const uint64_t free = extend();
+            init_block(free);
+            array[2*free] = static_cast<T>(block);
+            array[2*block] = static_cast<T>(free);
+            array[2*block+1] = defaultelement;
+            if ((pos-1)%2==0)
+                array[2*free+1] = obj;
+            else
+                array[pos-1] = obj;
+            return;
+        }
+        if (other!=blocks_){
+            // uninitialized written block, its storage holds the first element of other
+            const T first = array[2*block+1];
+            if (other==boundary){
+                boundary++;
+                array[2*other] = first;
+                unchain(other);
+            } else {
+                const uint64_t free = extend();
+                array[2*free] = static_cast<T>(other);
+                array[2*other] = static_cast<T>(free);
+                array[2*free+1] = first;
+            }
+            init_block(block);
+        }
+        array[pos-1] = obj;
+        unchain(block);
     }
 };
 
@@ -359,14 +747,24 @@ class RSBitmap{
     uint64_t size_slate=0;
     //! required amount of slates
     uint64_t amount_slates=0;
-    //! Choice dictionary array
-    ConstTimeArray<uint32_t>* cdarray=nullptr;
+    //! Choice dictionary array, amount of ones per slate +1, 0 marks uninitialized slates
+    InPlaceConstTimeArray<uint32_t>* cdarray=nullptr;
     //! speed up ranks select
     rank9sel* rsarray=nullptr;
     //! amount of ones
     size_t amount_1=0;
     //! init slates conditionally
     void _init_slate(const uint64_t slate);
+    //! amount of ones in an initialized slate
+    inline uint64_t _slate_ones(const uint64_t slate) const{
+        const uint32_t ones = cdarray->get(slate);
+        return ones>0 ? ones-1 : 0;
+    }
+    //! change amount of ones of an initialized slate
+    inline void _add_slate_ones(const uint64_t slate, const int64_t diff){
+        assert(cdarray->get(slate)>0);
+        cdarray->set(slate, static_cast<uint32_t>(cdarray->get(slate)+diff));
+    }
     // move constructor should be used. To force this, make CopyConstructor private
     //! Copy Constructor
     RSBitmap(const RSBitmap&);
@@ -399,6 +797,16 @@ public:
     /*! \return amount of blocks
     */
     inline uint64_t blocks() const noexcept{return blocks_;}
+    //! used memory by component
+    /*! \return SpaceReport with bit array, slate counters (dynamic) or rank9sel (static)
+    */
+    SpaceReport space_report() const;
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
     //! calculate amount of required blocks from pos/nbits
     /*! \param pos position
         \return required amount of blocks or 0
@@ -424,6 +832,12 @@ public:
     }
     //! improves efficiency of rank, select but make array static
     void make_static();
+    //! make a static array dynamic again, keeps the bits and reuses the bit array
+    /*! O(n/64) for counting the ones of every slate
+    */
+    void make_dynamic();
+    //! set all bits to 0 in constant time, a static array becomes dynamic
+    void clear();
     //! check if RSBitmap is static
     /*!
         \return is RSBitmap static
@@ -471,7 +885,7 @@ public:
         // if cdarray does not exist every bit is initialized
         if(!cdarray)
             return true;
-        return cdarray->is_init(find_slate(pos));
+        return cdarray->get(find_slate(pos))!=0;
     }
     //! compute rank
     /*! \param pos position of bit
@@ -516,6 +930,109 @@ public:
     //! endcond
 };
 
+//! An array of fixed width integers
+/*! \class BitPackedArray
+    Stores n elements with width bits each in ceil(n*width/64) blocks.
+    Elements are 1-based and initialized with 0.
+*/
+class BitPackedArray{
+    //! data array
+    uint64_t *array=nullptr;
+    //! amount of elements
+    uint64_t n_=0;
+    //! width of an element in bits
+    uint8_t width_=0;
+    //! mask with width ones
+    uint64_t mask_=0;
+    // move constructor should be used. To force this, make CopyConstructor private
+    //! Copy Constructor
+    BitPackedArray(const BitPackedArray&);
+public:
+    //! Constructor
+    /*! \param n amount of elements
+        \param width width of an element in bits (range 1-64)
+    */
+    BitPackedArray(const uint64_t n, const uint8_t width);
+    //! Move Constructor
+    BitPackedArray(BitPackedArray&&) noexcept;
+    //! Move assignment
+    BitPackedArray& operator=(BitPackedArray&&) noexcept;
+    //! Destructor
+    ~BitPackedArray();
+    //! explicit copy BitPackedArray.
+    /*!
+        \return copy
+    */
+    inline BitPackedArray copy() const{
+        // const attribute of function prevents move constructor
+        return BitPackedArray(*this);
+    }
+    //! calculate required width for storing values up to max_value
+    /*! \param max_value biggest value which should be stored
+        \return width in bits, at least 1
+    */
+    static uint8_t calc_width(const uint64_t max_value) noexcept;
+    //! max elements
+    /*! \return amount of elements
+    */
+    inline uint64_t n() const noexcept{return n_;}
+    //! width of elements
+    /*! \return width of an element in bits
+    */
+    inline uint8_t width() const noexcept{return width_;}
+    //! size in blocks
+    /*! \return amount of 64 bit blocks
+    */
+    inline uint64_t blocks() const noexcept{
+        return (n_*width_+63)/64;
+    }
+    //! used memory by component
+    /*! \return SpaceReport with the packed array
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        report.add("array", blocks()*sizeof(uint64_t));
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return blocks()*sizeof(uint64_t);
+    }
+    //! get element
+    /*! \param pos position of element
+        \return element or 0 if position is invalid
+    */
+    inline uint64_t get(const uint64_t pos) const{
+        if (pos==0 || pos>n_)
+            return 0;
+        const uint64_t start = (pos-1)*width_;
+        const uint8_t start_rest = start%64;
+        uint64_t ret = array[start/64]>>start_rest;
+        // element is split over two blocks
+        if (start_rest+width_>64)
+            ret |= array[start/64+1]<<(64-start_rest);
+        return ret&mask_;
+    }
+    //! set element
+    /*! \param pos position of element
+        \param value value, must fit into width
+    */
+    inline void set(const uint64_t pos, const uint64_t value){
+        SFLCHECK(pos>0 && pos<=n_)
+        SFLCHECK((value&mask_)==value)
+        const uint64_t start = (pos-1)*width_;
+        const uint8_t start_rest = start%64;
+        array[start/64] = (array[start/64]&~(mask_<<start_rest)) | (value<<start_rest);
+        // element is split over two blocks
+        if (start_rest+width_>64){
+            const uint8_t next_rest = 64-start_rest;
+            array[start/64+1] = (array[start/64+1]&~(mask_>>next_rest)) | (value>>next_rest);
+        }
+    }
+};
+
 //! helper for multi bit access
 /*!
     \tparam size amount of bits (possible range 1-64)
@@ -567,6 +1084,18 @@ public:
     uint64_t n() const noexcept{
         return bitmap.n()/size;
     }
+    //! used memory by component
+    /*! \return SpaceReport of the bitmap
+    */
+    SpaceReport space_report() const{
+        return bitmap.space_report();
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return bitmap.memory_usage();
+    }
 
     //! return amount of 1 in array
     /*! \return amount of 1 set
@@ -617,6 +1146,14 @@ public:
     void make_static(){
         bitmap.make_static();
     }
+    //! make array dynamic again, keeps elements
+    void make_dynamic(){
+        bitmap.make_dynamic();
+    }
+    //! reset all elements in constant time, makes array dynamic
+    void clear(){
+        bitmap.clear();
+    }
     //! check if RSBitmap is static
     /*!
         \return is RSBitmap static
@@ -670,6 +1207,18 @@ public:
     uint64_t n() const noexcept{
         return bitmap.n();
     }
+    //! used memory by component
+    /*! \return SpaceReport of the bitmap
+    */
+    SpaceReport space_report() const{
+        return bitmap.space_report();
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return bitmap.memory_usage();
+    }
     //! return amount of 1 in array
     /*! \return amount of 1 set
         Note: in this case this is the whole amount of elements in the array
@@ -720,6 +1269,14 @@ public:
     void make_static(){
         bitmap.make_static();
     }
+    //! make array dynamic again, keeps elements
+    void make_dynamic(){
+        bitmap.make_dynamic();
+    }
+    //! reset all elements in constant time, makes array dynamic
+    void clear(){
+        bitmap.clear();
+    }
     //! check if RSBitmap is static
     /*!
         \return is RSBitmap static
@@ -745,6 +1302,11 @@ class SegmentedArray
     RSBitmap segments_;
     RSBitmap notempty_;
 
+    template <std::size_t... Counter>
+    void report_arrays(SpaceReport &report, std::index_sequence<Counter...>) const{
+        (report.add("arrays."+std::to_string(Counter), std::get<Counter>(arrays).space_report()), ...);
+    }
+
     template <class Tuple, std::size_t... Counter>
     constexpr auto copy_arrays(Tuple &t, std::index_sequence<Counter...>) {
         return std::make_tuple(std::move(std::get<Counter>(t).copy())...);
@@ -869,6 +1431,7 @@ public:
         SFLCHECK(segment>0)
         SFLCHECK(pos>0)
         SFLCHECK(segment<=segments());
+        SFL_COUNT(counter_get_pos)
         // check if empty
         if (!this->notempty_.get(segment))
             return 0;
@@ -883,14 +1446,13 @@ public:
         assert(seg_beg<=size());
         return seg_beg;
     }
-    //! reset array
+    //! reset array in constant time without reallocation, static arrays become dynamic
     /*!
         \tparam SelArr select array
     */
     template<std::size_t SelArr>
     void reset(){
-        using arrtype = typename std::tuple_element<SelArr, SegArrays>::type;
-        std::get<SelArr>(this->arrays) = arrtype(size());
+        std::get<SelArr>(this->arrays).clear();
     }
     //! set item
     /*!
@@ -930,6 +1492,22 @@ public:
     const uint64_t segments() const noexcept{
         return amount_;
     }
+    //! used memory by component
+    /*! \return SpaceReport with segment bitmaps and all arrays (arrays.0, arrays.1, ...)
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        report.add("segments", segments_.space_report());
+        report.add("notempty", notempty_.space_report());
+        report_arrays(report, std::index_sequence_for<parameters...>{});
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
     //! segment size
     /* \param segment segment
        \return segment size
@@ -1035,16 +1613,32 @@ public:
 };
 
 
+//! buffer size of SpinStack and PackedSpinStack
+/*! \param size minimal buffer size
+    \return smallest power of two >= size
+*/
+inline uint64_t spin_buffer_size(const uint64_t size) noexcept{
+    uint64_t buffer_size=1;
+    while(buffer_size<size)
+        buffer_size <<= 1;
+    return buffer_size;
+}
 
 //! An efficient stack with fix size
 /*! \class SpinStack
     \tparam T type which will be saved in the stack
     static Stack which uses a spinpointer for efficiency
+    The buffer is rounded up to a power of two, so positions are masked instead of using modulo.
+    top and bottom are free running counters, the size is their difference.
 */
 template<class T>
 class SpinStack{
-    uint64_t limitter=0, pointer=0;
-    bool empty_=true;
+    //! position after the top element (free running)
+    uint64_t top_=0;
+    //! position of the bottom element (free running)
+    uint64_t bottom_=0;
+    //! buffer size-1, buffer size is a power of two
+    uint64_t mask_;
     T *array=nullptr;
 public:
     //! maximal stack size
@@ -1054,23 +1648,24 @@ public:
     //! Constructor
     /*! \param size maximal stack size
     */
-    SpinStack(const uint64_t size): n(size){
+    SpinStack(const uint64_t size): mask_(spin_buffer_size(size)-1), n(size){
         // check if type is compatible. Bad if it uses non trivial destructors
         static_assert(std::is_trivially_destructible<T>::value, "Type is not trivial destructable");
         assert(this->n>0);
         // allocate but don't initialize
-        this->array = static_cast<T*>(::operator new(sizeof(T)*this->n));
+        this->array = static_cast<T*>(::operator new(sizeof(T)*(this->mask_+1)));
     }
     SpinStack(const SpinStack& that) = delete;
     // steal pointer and invalidate pointer of dying instance
     //! Move Constructor
     SpinStack(SpinStack&& other) noexcept:
-        limitter(other.limitter),
-        pointer(other.pointer),
-        empty_(other.empty_),
+        top_(other.top_),
+        bottom_(other.bottom_),
+        mask_(other.mask_),
         n(other.n){
         this->array=other.array;
         other.array=nullptr;
+        other.top_=other.bottom_=0;
     }
     ~SpinStack() noexcept{
         if(this->array){
@@ -1084,10 +1679,7 @@ public:
     */
     T pop(){
         SFLCHECK(!empty())
-        pointer = (n+pointer-1)%n;
-        if (limitter==pointer)
-            empty_=true;
-        return array[pointer];
+        return array[--top_ & mask_];
     }
     //! Peek last element on stack
     /*! \return element T
@@ -1096,7 +1688,7 @@ public:
     */
     T peek(){
         SFLCHECK(!empty())
-        return array[(n+pointer-1)%n];
+        return array[(top_-1) & mask_];
     }
     //! Push element on the stack
     /*! \warning always check full() before push
@@ -1104,9 +1696,7 @@ public:
     */
     void push_top(T obj){
         SFLCHECK(!full())
-        array[pointer] = obj;
-        pointer=(pointer+1)%n;
-        empty_=false;
+        array[top_++ & mask_] = obj;
     }
     //! Push element on the bottom of the stack
     /*! \warning always check full() before push
@@ -1114,9 +1704,8 @@ public:
     */
     void push_bottom(T obj){
         SFLCHECK(!full())
-        limitter = (n+limitter-1)%n;
-        array[limitter] = obj;
-        empty_=false;
+        // wraps around like top_, buffer size divides 2^64
+        array[--bottom_ & mask_] = obj;
     }
     //! Drop number of elements at the front of the stac
     /*! \param num amount of elements at the front of the stack which will be dropped
@@ -1125,33 +1714,31 @@ public:
     */
     uint64_t drop_front(uint64_t num){
         uint64_t max_drop = std::min(size(), num);
-        limitter = (limitter+max_drop)%n;
-        if (limitter==pointer)
-            empty_=true;
+        if (max_drop>0){
+            SFL_COUNT(counter_stack_drop)
+            SFL_COUNT_N(counter_stack_dropped, max_drop)
+        }
+        bottom_ += max_drop;
         return max_drop;
     }
+    //! remove all elements
+    void clear() noexcept{
+        top_ = 0;
+        bottom_ = 0;
+    }
     //! size of stack
     /*! \return amount of elements on the stack
         Get current size of stack
     */
     uint64_t size(void) const noexcept{
-        if (empty()) {
-            return 0;
-        } else {
-            if (limitter >= pointer) {
-                return pointer+(n-limitter);
-            }
-            else {
-                return pointer-limitter;
-            }
-        }
+        return top_-bottom_;
     }
     //! is stack empty
     /*! \return if stack is empty
         Get empty state from stack
     */
     bool empty(void) const noexcept{
-        return empty_;
+        return top_==bottom_;
     }
     //! is stack full
     /*! \return if stack is full
@@ -1160,9 +1747,165 @@ public:
     bool full(void) const noexcept{
         return size()>=n;
     }
+    //! used memory by component
+    /*! \return SpaceReport with the buffer
+    */
+    SpaceReport space_report() const{
+        SpaceReport report;
+        report.add("array", sizeof(T)*(mask_+1));
+        return report;
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return sizeof(T)*(mask_+1);
+    }
 };
 
 
+//! An efficient stack with fix size and bit-packed (node, edge) entries
+/*! \class PackedSpinStack
+    Same interface as SpinStack<AdjEntry>, but every entry uses only
+    calc_width(max_node)+calc_width(max_edge) bits in a BitPackedArray.
+    Use fits() to check if entries fit into 64 bits.
+*/
+class PackedSpinStack{
+public:
+    //! type of the entries (compatible with AdjEntry)
+    typedef std::tuple<SFL_ID_SIZE, SFL_POS_SIZE> entry_t;
+private:
+    //! position after the top element (free running)
+    uint64_t top_=0;
+    //! position of the bottom element (free running)
+    uint64_t bottom_=0;
+    //! buffer size-1, buffer size is a power of two
+    uint64_t mask_;
+    //! width of the node part
+    uint8_t node_width_;
+    //! packed entries
+    BitPackedArray array;
+    //! pack entry
+    inline uint64_t _pack(const entry_t &obj) const{
+        return std::get<0>(obj) | (static_cast<uint64_t>(std::get<1>(obj))<<node_width_);
+    }
+    //! unpack entry
+    inline entry_t _unpack(const uint64_t value) const{
+        return entry_t(value&((UINT64_C(1)<<node_width_)-1), value>>node_width_);
+    }
+    //! value at free running position
+    inline uint64_t _get(const uint64_t pos) const{
+        // BitPackedArray is 1-based
+        return array.get((pos&mask_)+1);
+    }
+    //! set value at free running position
+    inline void _set(const uint64_t pos, const uint64_t value){
+        array.set((pos&mask_)+1, value);
+    }
+public:
+    //! maximal stack size
+    /*! \var n
+    */
+    const uint64_t n;
+    //! Constructor
+    /*! \param size maximal stack size
+        \param max_node biggest node id which will be stored
+        \param max_edge biggest edge position which will be stored
+    */
+    PackedSpinStack(const uint64_t size, const SFL_ID_SIZE max_node, const SFL_POS_SIZE max_edge);
+    PackedSpinStack(const PackedSpinStack& that) = delete;
+    //! Move Constructor
+    PackedSpinStack(PackedSpinStack&& other) noexcept;
+    //! check if entries fit into 64 bits
+    /*! \param max_node biggest node id which will be stored
+        \param max_edge biggest edge position which will be stored
+        \return can PackedSpinStack store these entries
+    */
+    static bool fits(const SFL_ID_SIZE max_node, const SFL_POS_SIZE max_edge) noexcept;
+    //! Pop last element from stack
+    /*! \return element
+        \warning always check empty() before pop
+    */
+    entry_t pop(){
+        SFLCHECK(!empty())
+        return _unpack(_get(--top_));
+    }
+    //! Peek last element on stack
+    /*! \return element
+        \warning always check empty() before peek
+    */
+    entry_t peek(){
+        SFLCHECK(!empty())
+        return _unpack(_get(top_-1));
+    }
+    //! Push element on the stack
+    /*! \warning always check full() before push
+    */
+    void push_top(const entry_t obj){
+        SFLCHECK(!full())
+        _set(top_++, _pack(obj));
+    }
+    //! Push element on the bottom of the stack
+    /*! \warning always check full() before push
+    */
+    void push_bottom(const entry_t obj){
+        SFLCHECK(!full())
+        _set(--bottom_, _pack(obj));
+    }
+    //! Drop number of elements at the front of the stack
+    /*! \param num amount of elements at the front of the stack which will be dropped
+        \return number of elements really dropped
+    */
+    uint64_t drop_front(uint64_t num){
+        uint64_t max_drop = std::min(size(), num);
+        if (max_drop>0){
+            SFL_COUNT(counter_stack_drop)
+            SFL_COUNT_N(counter_stack_dropped, max_drop)
+        }
+        bottom_ += max_drop;
+        return max_drop;
+    }
+    //! remove all elements
+    void clear() noexcept{
+        top_ = 0;
+        bottom_ = 0;
+    }
+    //! size of stack
+    /*! \return amount of elements on the stack
+    */
+    uint64_t size(void) const noexcept{
+        return top_-bottom_;
+    }
+    //! is stack empty
+    /*! \return if stack is empty
+    */
+    bool empty(void) const noexcept{
+        return top_==bottom_;
+    }
+    //! is stack full
+    /*! \return if stack is full
+    */
+    bool full(void) const noexcept{
+        return size()>=n;
+    }
+    //! width of an entry
+    /*! \return bits per entry
+    */
+    inline uint8_t width() const noexcept{return array.width();}
+    //! used memory by component
+    /*! \return SpaceReport with the packed buffer
+    */
+    SpaceReport space_report() const{
+        return array.space_report();
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return array.memory_usage();
+    }
+};
+
 //! A choice dictionary basing on RSBitmap
 /*! \class ChoiceDictionary
 */
@@ -1180,6 +1923,18 @@ public:
     /*! \var capacity
     */
     uint64_t capacity () const noexcept {return array.n();}
+    //! used memory by component
+    /*! \return SpaceReport of the bitmap
+    */
+    SpaceReport space_report() const{
+        return array.space_report();
+    }
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return array.memory_usage();
+    }
     //! insert
     /*! \param elem number to insert
         \return success of operation
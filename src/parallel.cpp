@@ -0,0 +1,421 @@
+#include "parallel.hpp"
+#include <thread>
+#include <vector>
+#include <limits>
+#include <algorithm>
+using namespace std;
+
+ConcurrentUnionFind::ConcurrentUnionFind(const uint64_t n): n_(n){
+    if (n==0)
+        return;
+    // every element is its own root
+    if (n<=UINT32_MAX){
+        this->parents32 = new std::atomic<uint32_t>[n];
+        for(uint64_t counter=0; counter<n; counter++)
+            this->parents32[counter].store(static_cast<uint32_t>(counter+1), std::memory_order_relaxed);
+    } else {
+        this->parents64 = new std::atomic<uint64_t>[n];
+        for(uint64_t counter=0; counter<n; counter++)
+            this->parents64[counter].store(counter+1, std::memory_order_relaxed);
+    }
+}
+
+ConcurrentUnionFind::ConcurrentUnionFind(ConcurrentUnionFind&& other) noexcept: n_(other.n_),
+merges(other.merges.load()){
+    this->parents32=other.parents32;
+    this->parents64=other.parents64;
+    other.parents32=nullptr;
+    other.parents64=nullptr;
+}
+
+ConcurrentUnionFind::~ConcurrentUnionFind(){
+    if(parents32)
+        delete[] parents32;
+    if(parents64)
+        delete[] parents64;
+}
+
+template<typename T>
+uint64_t ConcurrentUnionFind::_find(std::atomic<T> *parents, uint64_t elem){
+    T parent = parents[elem-1].load(std::memory_order_relaxed);
+    while(parent!=elem){
+        T grandparent = parents[parent-1].load(std::memory_order_relaxed);
+        // path halving, failing is harmless as another thread moved elem nearer to the root
+        if (grandparent!=parent)
+            parents[elem-1].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        elem = grandparent;
+        parent = parents[elem-1].load(std::memory_order_relaxed);
+    }
+    return elem;
+}
+
+template<typename T>
+bool ConcurrentUnionFind::_link(std::atomic<T> *parents, const uint64_t root, const uint64_t newroot){
+    T expected = static_cast<T>(root);
+    // fails if root is no root anymore
+    return parents[root-1].compare_exchange_strong(expected, static_cast<T>(newroot));
+}
+
+uint64_t ConcurrentUnionFind::find(const uint64_t elem){
+    if (elem==0 || elem>n())
+        return 0;
+    if (parents32)
+        return _find(parents32, elem);
+    return _find(parents64, elem);
+}
+
+bool ConcurrentUnionFind::unite(const uint64_t elem1, const uint64_t elem2){
+    SFLCHECK(elem1>0 && elem1<=n())
+    SFLCHECK(elem2>0 && elem2<=n())
+    uint64_t root1=elem1, root2=elem2;
+    bool linked;
+    do{
+        root1 = find(root1);
+        root2 = find(root2);
+        if (root1==root2)
+            return false;
+        // link bigger to smaller root, keeps the lowest element as representative and prevents cycles
+        if (root1<root2)
+            std::swap(root1, root2);
+        if (parents32)
+            linked = _link(parents32, root1, root2);
+        else
+            linked = _link(parents64, root1, root2);
+    } while(!linked);
+    merges.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ConcurrentUnionFind::same_component(const uint64_t elem1, const uint64_t elem2){
+    uint64_t root1=elem1, root2=elem2;
+    while(true){
+        root1 = find(root1);
+        root2 = find(root2);
+        if (root1==root2)
+            return true;
+        // root1 is still a root => sets were really different at this point
+        if (find(root1)==root1)
+            return false;
+    }
+}
+
+BitPackedArray ConcurrentUnionFind::flatten(const RSBitmap &ignore){
+    uint64_t label=0;
+    // components() counts the ignored elements too, so count the assigned labels
+    for(uint64_t elem=1; elem<=n(); elem++){
+        if (!ignore.get(elem) && find(elem)==elem)
+            label++;
+    }
+    BitPackedArray labels(n(), BitPackedArray::calc_width(label));
+    label = 0;
+    for(uint64_t elem=1; elem<=n(); elem++){
+        if (ignore.get(elem))
+            continue;
+        uint64_t root = find(elem);
+        // roots are the lowest elements so they are labeled first
+        if (root==elem)
+            labels.set(elem, ++label);
+        else
+            labels.set(elem, labels.get(root));
+    }
+    return labels;
+}
+
+SpaceReport ConcurrentUnionFind::space_report() const{
+    SpaceReport report;
+    if (parents32)
+        report.add("parents", n()*sizeof(std::atomic<uint32_t>));
+    if (parents64)
+        report.add("parents", n()*sizeof(std::atomic<uint64_t>));
+    return report;
+}
+
+unsigned default_threads(){
+    return std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+}
+
+void parallel_chunks(const uint64_t n, unsigned threads, const std::function<void (uint64_t, uint64_t)> &chunk_func){
+    const uint64_t chunk_size = 4096;
+    if (threads==0)
+        threads = default_threads();
+    std::atomic<uint64_t> next_chunk{1};
+    auto worker = [&next_chunk, &chunk_func, &n](){
+        uint64_t first;
+        while((first=next_chunk.fetch_add(chunk_size))<=n){
+            chunk_func(first, std::min(first+chunk_size-1, n));
+        }
+    };
+    // don't spawn threads for a single chunk
+    if (threads==1 || n<=chunk_size){
+        worker();
+        return;
+    }
+    std::vector<std::thread> pool;
+    for(unsigned counter=1; counter<threads; counter++)
+        pool.emplace_back(worker);
+    worker();
+    for(auto &thread: pool)
+        thread.join();
+}
+
+void parallel_node_chunks(const SFLGraph &graph, unsigned threads, const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE)> &chunk_func){
+    parallel_chunks(graph.n(), threads, chunk_func);
+}
+
+ConcurrentUnionFind union_find(const SFLGraph &graph, unsigned threads, const RSBitmap &removednodes){
+    ConcurrentUnionFind sets(graph.n());
+    std::function<void (SFL_ID_SIZE, SFL_ID_SIZE)> unite_chunk = [&graph, &sets, &removednodes](SFL_ID_SIZE first, SFL_ID_SIZE last){
+        SFL_ID_SIZE next_node;
+        for(SFL_ID_SIZE node=first; node<=last; node++){
+            if (removednodes.get(node))
+                continue;
+            SFL_POS_SIZE deg = graph.deg(node);
+            for(SFL_POS_SIZE edge=1; edge<=deg; edge++){
+                next_node = graph.head(node, edge);
+                // every edge is seen twice, use it only from the lower node
+                if (next_node<node || removednodes.get(next_node))
+                    continue;
+                sets.unite(node, next_node);
+            }
+        }
+    };
+    parallel_node_chunks(graph, threads, unite_chunk);
+    return sets;
+}
+
+const BitPackedArray connected_components_parallel(const SFLGraph &graph, unsigned threads, const RSBitmap &removednodes){
+    return union_find(graph, threads, removednodes).flatten(removednodes);
+}
+
+const RSBitmap spanning_forest_parallel(const SFLGraph &graph, unsigned threads, const RSBitmap &removednodes){
+    const edge_layout_t layout = edge_layout(graph);
+    // both positions of every tree edge, at most n-1 tree edges. Words, because the threads can't
+    // write to a shared bitmap or BitPackedArray
+    std::vector<uint64_t> positions(graph.n()>0 ? 2*(graph.n()-1) : 0);
+    std::atomic<uint64_t> positions_size{0};
+    ConcurrentUnionFind sets(graph.n());
+    parallel_node_chunks(graph, threads, [&](SFL_ID_SIZE first, SFL_ID_SIZE last){
+        std::vector<uint64_t> local;
+        SFL_ID_SIZE next_node;
+        SFL_POS_SIZE back_edge;
+        for(SFL_ID_SIZE node=first; node<=last; node++){
+            if (removednodes.get(node))
+                continue;
+            for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                std::tie(next_node, back_edge) = graph.mate(node, edge);
+                // every edge is seen twice, use it only from the lower node
+                if (next_node<node || removednodes.get(next_node))
+                    continue;
+                // exactly the edges joining two trees succeed
+                if (sets.unite(node, next_node)){
+                    local.push_back(layout.get_pos(node, edge));
+                    local.push_back(layout.get_pos(next_node, back_edge));
+                }
+            }
+        }
+        uint64_t start = positions_size.fetch_add(local.size());
+        std::copy(local.begin(), local.end(), positions.begin()+start);
+    });
+    RSBitmap forest(layout.size());
+    for(uint64_t index=0; index<positions_size.load(); index++)
+        forest.set(positions[index], true);
+    forest.make_static();
+    return forest;
+}
+
+// marks roots in the parent edges of the breadth-first forest, 0 marks unvisited (or removed) nodes
+static const SFL_POS_SIZE root_edge = std::numeric_limits<SFL_POS_SIZE>::max();
+
+const BlockLabels biconnected_labels_parallel(const SFLGraph &graph, unsigned threads, const RSBitmap &removednodes){
+    const SFL_ID_SIZE graph_n = graph.n();
+    // value initialized with 0
+    std::vector<std::atomic<SFL_POS_SIZE>> parent_edge(graph_n);
+    // nodes in breadth-first order, level by level
+    std::vector<SFL_ID_SIZE> order(graph_n);
+    std::vector<uint64_t> level_begin(1, 0);
+    std::atomic<uint64_t> order_size{0};
+    // reserve space once per chunk
+    auto append = [&order, &order_size](const std::vector<SFL_ID_SIZE> &local){
+        uint64_t start = order_size.fetch_add(local.size());
+        std::copy(local.begin(), local.end(), order.begin()+start);
+    };
+    // run node_func on all nodes of a level in parallel
+    auto for_level = [&order, &level_begin, &threads](const size_t level, auto node_func){
+        const uint64_t begin = level_begin[level];
+        parallel_chunks(level_begin[level+1]-begin, threads, [&order, &node_func, &begin](uint64_t first, uint64_t last){
+            for(uint64_t index=first; index<=last; index++)
+                node_func(order[begin+index-1]);
+        });
+    };
+    auto is_child = [&graph, &parent_edge](const SFL_ID_SIZE node, const SFL_POS_SIZE edge){
+        SFL_ID_SIZE next_node;
+        SFL_POS_SIZE back_edge;
+        std::tie(next_node, back_edge) = graph.mate(node, edge);
+        return parent_edge[next_node-1].load(std::memory_order_relaxed)==back_edge;
+    };
+
+    // roots are the lowest nodes of the components, like in the sequential depth-first-search
+    {
+        ConcurrentUnionFind components = union_find(graph, threads, removednodes);
+        parallel_node_chunks(graph, threads, [&](SFL_ID_SIZE first, SFL_ID_SIZE last){
+            std::vector<SFL_ID_SIZE> local;
+            for(SFL_ID_SIZE node=first; node<=last; node++){
+                if (removednodes.get(node) || components.find(node)!=node)
+                    continue;
+                parent_edge[node-1].store(root_edge, std::memory_order_relaxed);
+                local.push_back(node);
+            }
+            append(local);
+        });
+        level_begin.push_back(order_size.load());
+    }
+    // breadth-first spanning forest, the first thread claiming a node becomes its parent
+    while(level_begin.back()>level_begin[level_begin.size()-2]){
+        const uint64_t begin = level_begin[level_begin.size()-2];
+        parallel_chunks(level_begin.back()-begin, threads, [&](uint64_t first, uint64_t last){
+            std::vector<SFL_ID_SIZE> local;
+            SFL_ID_SIZE next_node;
+            SFL_POS_SIZE back_edge;
+            for(uint64_t index=first; index<=last; index++){
+                const SFL_ID_SIZE node = order[begin+index-1];
+                for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                    std::tie(next_node, back_edge) = graph.mate(node, edge);
+                    if (removednodes.get(next_node) || parent_edge[next_node-1].load(std::memory_order_relaxed)!=0)
+                        continue;
+                    SFL_POS_SIZE expected = 0;
+                    if (parent_edge[next_node-1].compare_exchange_strong(expected, back_edge, std::memory_order_relaxed))
+                        local.push_back(next_node);
+                }
+            }
+            append(local);
+        });
+        level_begin.push_back(order_size.load());
+    }
+    // the last level is empty
+    const size_t levels = level_begin.size()-2;
+
+    // block of the parent edge of every member, represented by a node of the block (0 for no block)
+    std::vector<SFL_ID_SIZE> rep(graph_n, 0);
+    {
+        std::vector<SFL_ID_SIZE> pre(graph_n), size(graph_n), low(graph_n), high(graph_n);
+        // subtree sizes bottom-up
+        for(size_t level=levels; level-->0;){
+            for_level(level, [&](const SFL_ID_SIZE node){
+                SFL_ID_SIZE subtree=1;
+                for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                    if (is_child(node, edge))
+                        subtree += size[graph.head(node, edge)-1];
+                }
+                size[node-1] = subtree;
+            });
+        }
+        // preorder top-down, children in the order of the edges
+        SFL_ID_SIZE next_pre = 1;
+        for(uint64_t index=level_begin[0]; index<level_begin[1]; index++){
+            pre[order[index]-1] = next_pre;
+            next_pre += size[order[index]-1];
+        }
+        for(size_t level=0; level<levels; level++){
+            for_level(level, [&](const SFL_ID_SIZE node){
+                SFL_ID_SIZE child_pre = pre[node-1]+1;
+                for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                    if (!is_child(node, edge))
+                        continue;
+                    pre[graph.head(node, edge)-1] = child_pre;
+                    child_pre += size[graph.head(node, edge)-1];
+                }
+            });
+        }
+        // lowest and highest preorder number reachable from the subtree with one non-tree edge
+        for(size_t level=levels; level-->0;){
+            for_level(level, [&](const SFL_ID_SIZE node){
+                SFL_ID_SIZE node_low = pre[node-1], node_high = pre[node-1];
+                SFL_ID_SIZE next_node;
+                for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                    next_node = graph.head(node, edge);
+                    if (removednodes.get(next_node) || parent_edge[node-1].load(std::memory_order_relaxed)==edge)
+                        continue;
+                    if (is_child(node, edge)){
+                        node_low = std::min(node_low, low[next_node-1]);
+                        node_high = std::max(node_high, high[next_node-1]);
+                    } else {
+                        node_low = std::min(node_low, pre[next_node-1]);
+                        node_high = std::max(node_high, pre[next_node-1]);
+                    }
+                }
+                low[node-1] = node_low;
+                high[node-1] = node_high;
+            });
+        }
+        auto is_ancestor = [&pre, &size](const SFL_ID_SIZE ancestor, const SFL_ID_SIZE node){
+            return pre[ancestor-1]<=pre[node-1] && pre[node-1]<pre[ancestor-1]+size[ancestor-1];
+        };
+        // tree edges are represented by their child, unite the ones in the same block
+        ConcurrentUnionFind blocks(graph_n);
+        parallel_node_chunks(graph, threads, [&](SFL_ID_SIZE first, SFL_ID_SIZE last){
+            SFL_ID_SIZE next_node;
+            for(SFL_ID_SIZE node=first; node<=last; node++){
+                const SFL_POS_SIZE node_parent_edge = parent_edge[node-1].load(std::memory_order_relaxed);
+                if (node_parent_edge==0)
+                    continue;
+                if (node_parent_edge!=root_edge){
+                    next_node = graph.head(node, node_parent_edge);
+                    // the subtree reaches out of the subtree of the parent, parent edge of the parent is in the same block
+                    if (parent_edge[next_node-1].load(std::memory_order_relaxed)!=root_edge &&
+                        (low[node-1]<pre[next_node-1] || high[node-1]>=pre[next_node-1]+size[next_node-1]))
+                        blocks.unite(node, next_node);
+                }
+                for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                    next_node = graph.head(node, edge);
+                    // every non-tree edge once
+                    if (next_node<node || edge==node_parent_edge || removednodes.get(next_node) || is_child(node, edge))
+                        continue;
+                    // a non-tree edge between different subtrees closes a cycle over both parent edges
+                    if (!is_ancestor(node, next_node) && !is_ancestor(next_node, node))
+                        blocks.unite(node, next_node);
+                }
+            }
+        });
+        parallel_node_chunks(graph, threads, [&](SFL_ID_SIZE first, SFL_ID_SIZE last){
+            for(SFL_ID_SIZE node=first; node<=last; node++){
+                const SFL_POS_SIZE node_parent_edge = parent_edge[node-1].load(std::memory_order_relaxed);
+                // roots, removed nodes and bridges (no edge leaves the subtree) have no block
+                if (node_parent_edge==0 || node_parent_edge==root_edge || (low[node-1]>=pre[node-1] && high[node-1]<pre[node-1]+size[node-1]))
+                    continue;
+                rep[node-1] = blocks.find(node);
+            }
+        });
+    }
+
+    // number the blocks like biconnected_labels: by top, then by the first edge of the top into the block
+    std::vector<SFL_ID_SIZE> top(graph_n, 0);
+    for(SFL_ID_SIZE node=1; node<=graph_n; node++){
+        if (rep[node-1]==0)
+            continue;
+        SFL_ID_SIZE parent = graph.head(node, parent_edge[node-1].load(std::memory_order_relaxed));
+        if (rep[parent-1]!=rep[node-1])
+            top[rep[node-1]-1] = parent;
+    }
+    std::vector<SFL_ID_SIZE> block_id(graph_n, 0);
+    std::vector<uint64_t> top_counts(graph_n, 0);
+    uint64_t block=0;
+    for(SFL_ID_SIZE node=1; node<=graph_n; node++){
+        if (removednodes.get(node))
+            continue;
+        for(SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            SFL_ID_SIZE next_rep = rep[graph.head(node, edge)-1];
+            if (next_rep==0 || top[next_rep-1]!=node || block_id[next_rep-1]!=0)
+                continue;
+            block_id[next_rep-1] = ++block;
+            top_counts[node-1]++;
+        }
+    }
+    SegmentedArray<> tops(top_counts.begin(), top_counts.end());
+    assert(tops.size()==block);
+    BitPackedArray labels(graph_n, BitPackedArray::calc_width(block));
+    for(SFL_ID_SIZE node=1; node<=graph_n; node++){
+        if (rep[node-1]!=0)
+            labels.set(node, block_id[rep[node-1]-1]);
+    }
+    return BlockLabels(std::move(labels), std::move(tops));
+}
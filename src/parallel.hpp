@@ -0,0 +1,154 @@
+/*! \file parallel.hpp
+    \author Alexander Kaftan
+    \brief Parallel graph routines
+*/
+
+#ifndef spacefparallel
+#define spacefparallel
+
+#include "commondefinitions.h"
+
+#include "fgraph.hpp"
+#include "misc.hpp"
+#include "graph.hpp"
+#include <atomic>
+#include <functional>
+
+//! A lock-free union-find
+/*! \class ConcurrentUnionFind
+    Elements are 1-based. Every set is represented by its lowest element.
+    find uses path halving, unite links the bigger root to the smaller one with compare and swap.
+    The parent array uses 32 bit entries if possible.
+    All operations except flatten may be called concurrently.
+*/
+class ConcurrentUnionFind{
+    //! amount of elements
+    uint64_t n_;
+    //! parent array (if n<=UINT32_MAX)
+    std::atomic<uint32_t> *parents32=nullptr;
+    //! parent array (else)
+    std::atomic<uint64_t> *parents64=nullptr;
+    //! amount of successful unions
+    std::atomic<uint64_t> merges{0};
+    template<typename T>
+    static uint64_t _find(std::atomic<T> *parents, uint64_t elem);
+    template<typename T>
+    static bool _link(std::atomic<T> *parents, const uint64_t root, const uint64_t newroot);
+public:
+    //! Constructor
+    /*! \param n amount of elements, every element is an own set
+    */
+    ConcurrentUnionFind(const uint64_t n);
+    ConcurrentUnionFind(const ConcurrentUnionFind&) = delete;
+    //! Move Constructor
+    ConcurrentUnionFind(ConcurrentUnionFind&&) noexcept;
+    //! Destructor
+    ~ConcurrentUnionFind();
+    //! max elements
+    /*! \return amount of elements
+    */
+    inline uint64_t n() const noexcept{return n_;}
+    //! find representative
+    /*! \param elem element
+        \return lowest element of the set of elem (0 for invalid elements)
+    */
+    uint64_t find(const uint64_t elem);
+    //! unite sets
+    /*! \param elem1 element
+        \param elem2 element
+        \return true if two different sets were united
+    */
+    bool unite(const uint64_t elem1, const uint64_t elem2);
+    //! check if elements are in the same set
+    /*! \param elem1 element
+        \param elem2 element
+        \return are elements in the same set
+    */
+    bool same_component(const uint64_t elem1, const uint64_t elem2);
+    //! amount of sets
+    /*! \return amount of sets
+    */
+    uint64_t components() const noexcept{
+        return n_-merges.load();
+    }
+    //! compact labels
+    /*! \param ignore RSBitmap with elements which get label 0 (must be own sets)
+        \return BitPackedArray with 1-based labels ordered by the lowest element of every set,
+        the width fits the amount of labels (ignored elements aren't counted)
+        \warning not thread safe
+    */
+    BitPackedArray flatten(const RSBitmap &ignore=null_bitmap);
+    //! used memory by component
+    /*! \return SpaceReport with the parent array
+    */
+    SpaceReport space_report() const;
+    //! used memory
+    /*! \return bytes
+    */
+    uint64_t memory_usage() const{
+        return space_report().total();
+    }
+};
+
+//! amount of threads used by default
+/*! \return hardware concurrency, at least 1
+*/
+unsigned default_threads();
+
+//! run a function on chunks of a range in parallel
+/*! \param n amount of elements, the range is 1..n
+    \param threads amount of threads (0=default_threads())
+    \param chunk_func function taking first and last element of a chunk
+    Threads take chunks dynamically for load balancing. Small ranges run in the calling thread.
+*/
+void parallel_chunks(const uint64_t n, unsigned threads, const std::function<void (uint64_t, uint64_t)> &chunk_func);
+
+//! run a function on chunks of nodes in parallel
+/*! \param graph Graph object
+    \param threads amount of threads (0=default_threads())
+    \param chunk_func function taking first and last node of a chunk
+    Threads take chunks dynamically for load balancing.
+*/
+void parallel_node_chunks(const SFLGraph &graph, unsigned threads, const std::function<void (SFL_ID_SIZE, SFL_ID_SIZE)> &chunk_func);
+
+//! union-find over all edges of graph
+/*! \param graph Graph object
+    \param threads amount of threads (0=default_threads())
+    \param removednodes RSBitmap with removed nodes
+    \return ConcurrentUnionFind with a set for every connected component
+*/
+ConcurrentUnionFind union_find(const SFLGraph &graph, unsigned threads=0, const RSBitmap &removednodes=null_bitmap);
+
+//! Connected Components as compact labels (parallel)
+/*! \param graph Graph object
+    \param threads amount of threads (0=default_threads())
+    \param removednodes RSBitmap with removed nodes
+    \return BitPackedArray with the 1-based component of every node (0 for removed nodes)
+    Same labels as connected_components.
+*/
+const BitPackedArray connected_components_parallel(const SFLGraph &graph, unsigned threads=0, const RSBitmap &removednodes=null_bitmap);
+
+//! spanning forest (parallel)
+/*! \param graph Graph object
+    \param threads amount of threads (0=default_threads())
+    \param removednodes RSBitmap with removed nodes
+    \return static RSBitmap in the layout of annotated_edges_t with both directions of every tree edge set
+    The edges which united two sets of a ConcurrentUnionFind, no depth-first-search order.
+    Use ForestCSR for a rooted version. Needs O(n) words of temporary memory, the threads collect the
+    positions of the tree edges before they are set in the bitmap.
+*/
+const RSBitmap spanning_forest_parallel(const SFLGraph &graph, unsigned threads=0, const RSBitmap &removednodes=null_bitmap);
+
+//! Bi-Connected Components as compact labels (parallel)
+/*! \param graph Graph object
+    \param threads amount of threads (0=default_threads())
+    \param removednodes RSBitmap with removed nodes
+    \return BlockLabels, same labels as biconnected_labels
+    Tarjan-Vishkin: builds a breadth-first spanning forest rooted in the lowest node of every component,
+    computes preorder, subtree sizes and low/high points level by level and unites tree edges with a
+    ConcurrentUnionFind. Every level runs in parallel, so the depth of the forest bounds the parallelism.
+    Needs O(n) words of temporary memory and no annotated_edges.
+*/
+const BlockLabels biconnected_labels_parallel(const SFLGraph &graph, unsigned threads=0, const RSBitmap &removednodes=null_bitmap);
+
+#endif
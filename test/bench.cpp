@@ -0,0 +1,400 @@
+#include "../src/commondefinitions.h"
+#include "../src/misc.hpp"
+#include "../src/fgraph.hpp"
+#include "../src/graph.hpp"
+#include "../src/parallel.hpp"
+#include "thirdparty/Catch2/include/external/clara.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+// benchmark harness with the json output format of Google Benchmark
+
+//! result of a benchmark
+struct bench_result{
+    std::string name;
+    uint64_t iterations;
+    double real_time;
+    double cpu_time;
+    // for bytes_per_second, 0 if not used
+    uint64_t bytes;
+};
+
+//! global settings and results
+struct bench_state{
+    std::string filter;
+    double min_time=0.5;
+    uint64_t repetitions=1;
+    std::vector<bench_result> results;
+};
+
+// prevent that the compiler removes results
+static volatile uint64_t bench_sink;
+template<typename T>
+inline void do_not_optimize(const T &value){
+    bench_sink = static_cast<uint64_t>(value);
+}
+
+// fast deterministic positions
+static std::vector<uint64_t> random_positions(const uint64_t count, const uint64_t max, const uint64_t seed=42){
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<uint64_t> dist(1, max);
+    std::vector<uint64_t> positions(count);
+    for (auto &pos: positions)
+        pos = dist(gen);
+    return positions;
+}
+
+// run func(iterations) with increasing iterations until min_time is reached
+static void run_benchmark(bench_state &state, const std::string &name, const std::function<void (uint64_t)> &func, const uint64_t bytes_per_iteration=0){
+    if (name.find(state.filter)==std::string::npos)
+        return;
+    for (uint64_t repetition=0; repetition<state.repetitions; repetition++){
+        uint64_t iterations=1;
+        while(true){
+            std::clock_t cpu_start = std::clock();
+            auto real_start = std::chrono::steady_clock::now();
+            func(iterations);
+            double real = std::chrono::duration<double>(std::chrono::steady_clock::now()-real_start).count();
+            double cpu = static_cast<double>(std::clock()-cpu_start)/CLOCKS_PER_SEC;
+            // too short: scale up like Google Benchmark
+            if (real<state.min_time && iterations<(UINT64_C(1)<<40)){
+                double factor = real>0 ? std::min(10.0, 1.4*state.min_time/real) : 10.0;
+                iterations = std::max<uint64_t>(iterations+1, iterations*factor);
+                continue;
+            }
+            state.results.push_back({name, iterations, real*1e9/iterations, cpu*1e9/iterations, bytes_per_iteration});
+            std::cerr << name << ": " << real*1e9/iterations << " ns (" << iterations << " iterations)" << std::endl;
+            break;
+        }
+    }
+}
+
+// escape for json strings
+static std::string json_escape(const std::string &in){
+    std::string out;
+    for (char c: in){
+        if (c=='"' || c=='\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static void write_json(const bench_state &state, std::ostream &out){
+    std::time_t now = std::time(nullptr);
+    char date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\",\n";
+#else
+    out << "    \"library_build_type\": \"debug\",\n";
+#endif
+    out << "    \"min_time\": " << state.min_time << ",\n";
+    out << "    \"repetitions\": " << state.repetitions << "\n  },\n";
+    out << "  \"benchmarks\": [";
+    for (size_t counter=0; counter<state.results.size(); counter++){
+        const bench_result &result = state.results[counter];
+        out << (counter ? ",\n" : "\n");
+        out << "    {\n      \"name\": \"" << json_escape(result.name) << "\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"real_time\": " << result.real_time << ",\n";
+        out << "      \"cpu_time\": " << result.cpu_time << ",\n";
+        if (result.bytes)
+            out << "      \"bytes_per_second\": " << result.bytes*1e9/result.real_time << ",\n";
+        out << "      \"time_unit\": \"ns\"\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void bench_rsbitmap(bench_state &state, const uint64_t nbits){
+    const std::vector<uint64_t> positions = random_positions(1024, nbits);
+    const std::vector<uint64_t> ranks = random_positions(1024, nbits/4);
+    for (bool is_static: {false, true}){
+        const std::string prefix = std::string("RSBitmap/")+(is_static ? "static/" : "dynamic/");
+        RSBitmap bitmap(nbits);
+        // about every second bit is set
+        for (uint64_t pos: random_positions(nbits, nbits, 7))
+            bitmap.set(pos, true);
+        if (is_static)
+            bitmap.make_static();
+        run_benchmark(state, prefix+"get", [&](uint64_t iterations){
+            uint64_t sum=0;
+            for (uint64_t counter=0; counter<iterations; counter++)
+                sum += bitmap.get(positions[counter%1024]);
+            do_not_optimize(sum);
+        });
+        run_benchmark(state, prefix+"rank", [&](uint64_t iterations){
+            uint64_t sum=0;
+            for (uint64_t counter=0; counter<iterations; counter++)
+                sum += bitmap.rank(positions[counter%1024]);
+            do_not_optimize(sum);
+        });
+        run_benchmark(state, prefix+"select", [&](uint64_t iterations){
+            uint64_t sum=0;
+            for (uint64_t counter=0; counter<iterations; counter++)
+                sum += bitmap.select(ranks[counter%1024]);
+            do_not_optimize(sum);
+        });
+        run_benchmark(state, prefix+"next_one", [&](uint64_t iterations){
+            uint64_t sum=0;
+            for (uint64_t counter=0; counter<iterations; counter++)
+                sum += bitmap.next_one(positions[counter%1024]);
+            do_not_optimize(sum);
+        });
+    }
+    // set is only possible on dynamic bitmaps
+    RSBitmap bitmap(nbits);
+    run_benchmark(state, "RSBitmap/dynamic/set", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++)
+            bitmap.set(positions[counter%1024], counter&1);
+        do_not_optimize(bitmap.ones());
+    });
+    run_benchmark(state, "RSBitmap/construct", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++){
+            RSBitmap temp(nbits);
+            do_not_optimize(temp.n());
+        }
+    }, (nbits+7)/8);
+}
+
+static void bench_consttimearray(bench_state &state, const uint64_t n){
+    const std::vector<uint64_t> positions = random_positions(1024, n);
+    ConstTimeArray<uint32_t> t_array(n, 1);
+    run_benchmark(state, "ConstTimeArray/set", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++)
+            t_array.set(positions[counter%1024], counter);
+    });
+    run_benchmark(state, "ConstTimeArray/get", [&](uint64_t iterations){
+        uint64_t sum=0;
+        for (uint64_t counter=0; counter<iterations; counter++)
+            sum += t_array.get(positions[counter%1024]);
+        do_not_optimize(sum);
+    });
+    run_benchmark(state, "ConstTimeArray/construct", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++){
+            ConstTimeArray<uint32_t> temp(n, 0);
+            do_not_optimize(temp.n());
+        }
+    });
+}
+
+static void bench_segmentedarray(bench_state &state, const SFLGraph &graph){
+    annotated_edges_t annotated = annotate_edges(graph);
+    const std::vector<uint64_t> nodes = random_positions(1024, graph.n());
+    run_benchmark(state, "SegmentedArray/get_pos", [&](uint64_t iterations){
+        uint64_t sum=0;
+        for (uint64_t counter=0; counter<iterations; counter++){
+            SFL_ID_SIZE node = nodes[counter%1024];
+            sum += annotated.get_pos(node, std::max<SFL_POS_SIZE>(graph.deg(node), 1));
+        }
+        do_not_optimize(sum);
+    });
+    run_benchmark(state, "SegmentedArray/select_segment_pos", [&](uint64_t iterations){
+        uint64_t sum=0;
+        for (uint64_t counter=0; counter<iterations; counter++)
+            sum += annotated.select_segment_pos(std::get<edges_parent>(annotated.arrays), nodes[counter%1024], 1);
+        do_not_optimize(sum);
+    });
+}
+
+static void bench_stacks(bench_state &state){
+    const uint64_t size=4096;
+    SpinStack<AdjEntry> stack(size);
+    run_benchmark(state, "SpinStack/push_pop", [&](uint64_t iterations){
+        uint64_t sum=0;
+        for (uint64_t counter=0; counter<iterations; counter++){
+            stack.push_top(AdjEntry(counter, 1));
+            if (stack.full())
+                stack.drop_front(size/2);
+            if (counter%3==0)
+                sum += std::get<0>(stack.pop());
+        }
+        do_not_optimize(sum);
+    });
+    PackedSpinStack packed_stack(size, UINT32_MAX, UINT16_MAX);
+    run_benchmark(state, "PackedSpinStack/push_pop", [&](uint64_t iterations){
+        uint64_t sum=0;
+        for (uint64_t counter=0; counter<iterations; counter++){
+            packed_stack.push_top(AdjEntry(counter&UINT32_MAX, 1));
+            if (packed_stack.full())
+                packed_stack.drop_front(size/2);
+            if (counter%3==0)
+                sum += std::get<0>(packed_stack.pop());
+        }
+        do_not_optimize(sum);
+    });
+}
+
+static void bench_choicedictionary(bench_state &state, const uint64_t n){
+    const std::vector<uint64_t> positions = random_positions(1024, n);
+    ChoiceDictionary dict(n);
+    run_benchmark(state, "ChoiceDictionary/insert_remove", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++){
+            if (counter&1)
+                dict.remove(positions[counter%1024]);
+            else
+                dict.insert(positions[counter%1024]);
+        }
+        do_not_optimize(dict.size());
+    });
+    for (uint64_t pos: positions)
+        dict.insert(pos);
+    run_benchmark(state, "ChoiceDictionary/choice", [&](uint64_t iterations){
+        uint64_t sum=0;
+        for (uint64_t counter=0; counter<iterations; counter++)
+            sum += dict.choice();
+        do_not_optimize(sum);
+    });
+}
+
+static void bench_graph(bench_state &state, const std::string &graphname, const SFLGraph &graph){
+    const std::string prefix = "graph/"+graphname+"/";
+    // bytes of the adjacency arrays as reference for the throughput
+    const uint64_t bytes = graph.memory_usage();
+    run_benchmark(state, prefix+"dfs", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++){
+            uint64_t visited=0;
+            dfs(graph, 0, dfs_placeholder, dfs_placeholder, [&visited](SFL_ID_SIZE, SFL_POS_SIZE, bool){visited++; return true;});
+            do_not_optimize(visited);
+        }
+    }, bytes);
+    run_benchmark(state, prefix+"annotate_edges", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++){
+            annotated_edges_t annotated = annotate_edges(graph);
+            do_not_optimize(annotated.size());
+        }
+    }, bytes);
+    annotated_edges_t annotated = annotate_edges(graph);
+    run_benchmark(state, prefix+"cutvertices", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++)
+            do_not_optimize(cutvertices(graph, annotated).ones());
+    }, bytes);
+    run_benchmark(state, prefix+"biconnected_components", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++){
+            uint64_t components=0;
+            biconnected_components(graph, annotated, [&components](SFL_ID_SIZE, bool new_component){components+=new_component;});
+            do_not_optimize(components);
+        }
+    }, bytes);
+    run_benchmark(state, prefix+"biconnected_labels", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++)
+            do_not_optimize(biconnected_labels(graph, annotated).blocks());
+    }, bytes);
+    run_benchmark(state, prefix+"biconnected_labels_parallel", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++)
+            do_not_optimize(biconnected_labels_parallel(graph).blocks());
+    }, bytes);
+    // same traversals after relabeling for locality
+    run_benchmark(state, prefix+"relabel_rcm", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++)
+            do_not_optimize(relabel(graph, relabel_rcm).graph().n());
+    }, bytes);
+    const RelabeledGraph relabeled = relabel(graph, relabel_rcm);
+    run_benchmark(state, prefix+"annotate_edges_rcm", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++){
+            annotated_edges_t relabeled_annotated = annotate_edges(relabeled.graph());
+            do_not_optimize(relabeled_annotated.size());
+        }
+    }, bytes);
+    annotated_edges_t relabeled_annotated = annotate_edges(relabeled.graph());
+    run_benchmark(state, prefix+"cutvertices_rcm", [&](uint64_t iterations){
+        for (uint64_t counter=0; counter<iterations; counter++)
+            do_not_optimize(cutvertices(relabeled, relabeled_annotated).ones());
+    }, bytes);
+}
+
+int main( int argc, char* argv[] ) {
+    bench_state state;
+    std::string jsonpath="-";
+    std::vector<std::string> graphpaths;
+    uint64_t size=1<<14;
+    bool skip_micro=false;
+    bool skip_macro=false;
+    bool help=false;
+    auto cli = Catch::clara::Opt( state.filter, "filter" )
+    ["--filter"]
+    ("only run benchmarks containing filter")
+    | Catch::clara::Opt( state.min_time, "seconds" )
+    ["--min-time"]
+    ("minimal time per benchmark")
+    | Catch::clara::Opt( state.repetitions, "repetitions" )
+    ["--repetitions"]
+    ("repeat every benchmark")
+    | Catch::clara::Opt( size, "size" )
+    ["-s"]["--size"]
+    ("amount of nodes of synthetic graphs and elements of micro benchmarks")
+    | Catch::clara::Opt( jsonpath, "json" )
+    ["-o"]["--json"]
+    ("json output file, - for stdout")
+    | Catch::clara::Opt( skip_micro )
+    ["--no-micro"]
+    ("skip benchmarks of data structures")
+    | Catch::clara::Opt( skip_macro )
+    ["--no-macro"]
+    ("skip benchmarks of graph algorithms")
+    | Catch::clara::Help( help )
+    ["-h"]["--help"]
+    ("help")
+    | Catch::clara::Arg( graphpaths, "graphs" )
+    ("additional graphs (.dot requires boost, else adjacency format)");
+
+    auto result = cli.parse( Catch::clara::Args( argc, argv ) );
+    if( !result || help || size<2 ){
+        std::cout << cli << std::endl;
+        return 1;
+    }
+    if (!skip_micro){
+        bench_rsbitmap(state, size*64);
+        bench_consttimearray(state, size);
+        bench_stacks(state);
+        bench_choicedictionary(state, size);
+        bench_segmentedarray(state, SFLGraph::create_erdos_renyi(size, 8.0/size));
+    }
+    if (!skip_macro){
+        // topologies with different dfs depth and amount of blocks, average degree about 8 if possible
+        const std::string suffix = "_"+std::to_string(size);
+        const uint8_t scale = BitPackedArray::calc_width(size)-1;
+        const SFL_ID_SIZE side = std::sqrt(size);
+        bench_graph(state, "erdos_renyi"+suffix, SFLGraph::create_erdos_renyi(size, 8.0/size));
+        bench_graph(state, "rmat_"+std::to_string(UINT64_C(1)<<scale), SFLGraph::create_rmat(scale, 8));
+        bench_graph(state, "geometric"+suffix, SFLGraph::create_geometric(size, std::sqrt(8.0/(M_PI*size))));
+        bench_graph(state, "path"+suffix, SFLGraph::create_path(size));
+        bench_graph(state, "star"+suffix, SFLGraph::create_star(size));
+        bench_graph(state, "clique_chain"+suffix, SFLGraph::create_clique_chain(size/4, 5));
+        bench_graph(state, "grid_"+std::to_string(side)+"x"+std::to_string(side), SFLGraph::create_grid(side, side));
+        for (const std::string &graphpath: graphpaths){
+            std::ifstream filestrm(graphpath, std::ifstream::in);
+            if(!filestrm.is_open()){
+                std::cerr << "invalid file: " << graphpath << std::endl;
+                return 1;
+            }
+            std::string graphname = graphpath.substr(graphpath.find_last_of('/')+1);
+#ifdef USE_BOOST
+            if (graphpath.size()>4 && graphpath.compare(graphpath.size()-4, 4, ".dot")==0){
+                bench_graph(state, graphname, SFLGraph::create_from_dot(filestrm));
+                continue;
+            }
+#endif
+            bench_graph(state, graphname, SFLGraph::create_from_adj(filestrm));
+        }
+    }
+    if (jsonpath=="-"){
+        write_json(state, std::cout);
+    } else {
+        std::ofstream out(jsonpath);
+        write_json(state, out);
+    }
+    return 0;
+}
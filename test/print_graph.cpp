@@ -2,6 +2,7 @@
 #include "../src/graph.hpp"
 #include "../src/commondefinitions.h"
 #include "../src/fgraph.hpp"
+#include "../src/counters.hpp"
 #include "thirdparty/Catch2/include/external/clara.hpp"
 
 #include <iostream>
@@ -9,6 +10,159 @@
 #include <cstdlib>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <new>
+#include <sys/resource.h>
+
+// count allocations of the whole process for --stats and --trace
+static std::atomic<uint64_t> allocated_bytes{0};
+static std::atomic<uint64_t> allocations{0};
+
+void* operator new(std::size_t size){
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size>0 ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+// new[] and delete[] forward to these by default. GCC doesn't see that operator new is replaced as
+// well and warns about free on memory of new once it inlines operator delete.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__>=11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept{
+    std::free(ptr);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__>=11
+#pragma GCC diagnostic pop
+#endif
+
+//! measurements of a phase
+struct phase_stats{
+    std::string name;
+    // start relative to program start
+    double start_us;
+    double wall_us;
+    double cpu_us;
+    // peak resident set size during the phase (of the whole process if it couldn't be reset)
+    uint64_t peak_rss;
+    // peak_rss was reset at the begin of the phase
+    bool phase_peak;
+    uint64_t allocated;
+    uint64_t allocation_count;
+};
+
+//! records phases one after another
+class PhaseRecorder{
+    std::chrono::steady_clock::time_point program_start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point phase_start;
+    double cpu_start=0;
+    uint64_t allocated_start=0, allocations_start=0;
+    std::string current;
+    static double cpu_time_us(){
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return (usage.ru_utime.tv_sec+usage.ru_stime.tv_sec)*1e6+usage.ru_utime.tv_usec+usage.ru_stime.tv_usec;
+    }
+    bool peak_reset=false;
+    // reset the peak resident set size to the current one (linux only)
+    static bool reset_peak_rss(){
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+        clear_refs.close();
+        return !clear_refs.fail();
+    }
+    static uint64_t peak_rss(){
+        // VmHWM is reset by clear_refs, ru_maxrss isn't
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)){
+            if (line.compare(0, 6, "VmHWM:")==0)
+                return std::strtoull(line.c_str()+6, nullptr, 10)*1024;
+        }
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        // kilobytes on linux
+        return static_cast<uint64_t>(usage.ru_maxrss)*1024;
+    }
+    // escape for json strings
+    static std::string json_escape(const std::string &in){
+        std::string out;
+        for (char c: in){
+            if (c=='"' || c=='\\')
+                out += '\\';
+            out += c;
+        }
+        return out;
+    }
+    static const char *peak_key(const phase_stats &phase){
+        return phase.phase_peak ? "peak_rss_bytes" : "process_peak_rss_bytes";
+    }
+public:
+    std::vector<phase_stats> phases;
+    //! start phase, ends the running phase
+    void begin(const std::string &name){
+        if (!current.empty())
+            end();
+        current = name;
+        peak_reset = reset_peak_rss();
+        phase_start = std::chrono::steady_clock::now();
+        cpu_start = cpu_time_us();
+        allocated_start = allocated_bytes.load();
+        allocations_start = allocations.load();
+    }
+    //! end running phase
+    void end(){
+        if (current.empty())
+            return;
+        auto now = std::chrono::steady_clock::now();
+        phases.push_back({current,
+            std::chrono::duration<double, std::micro>(phase_start-program_start).count(),
+            std::chrono::duration<double, std::micro>(now-phase_start).count(),
+            cpu_time_us()-cpu_start,
+            peak_rss(),
+            peak_reset,
+            allocated_bytes.load()-allocated_start,
+            allocations.load()-allocations_start});
+        current.clear();
+    }
+    //! write phases as json object
+    /*! peak_rss_bytes is the peak of the phase, process_peak_rss_bytes (if the peak couldn't be reset)
+        the peak of the process up to the end of the phase
+    */
+    void write_stats(std::ostream &out, const std::string &graphpath) const{
+        out << "{\n  \"graph\": \"" << json_escape(graphpath) << "\",\n  \"phases\": [";
+        for (size_t counter=0; counter<phases.size(); counter++){
+            const phase_stats &phase = phases[counter];
+            out << (counter ? ",\n" : "\n");
+            out << "    {\"name\": \"" << json_escape(phase.name) << "\", \"wall_us\": " << phase.wall_us;
+            out << ", \"cpu_us\": " << phase.cpu_us << ", \"" << peak_key(phase) << "\": " << phase.peak_rss;
+            out << ", \"allocated_bytes\": " << phase.allocated << ", \"allocations\": " << phase.allocation_count << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+    //! write phases in chrome trace format (chrome://tracing, perfetto)
+    void write_trace(std::ostream &out) const{
+        out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+        for (size_t counter=0; counter<phases.size(); counter++){
+            const phase_stats &phase = phases[counter];
+            out << (counter ? ",\n" : "\n");
+            out << "  {\"name\": \"" << json_escape(phase.name) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1";
+            out << ", \"ts\": " << phase.start_us << ", \"dur\": " << phase.wall_us;
+            out << ", \"args\": {\"cpu_us\": " << phase.cpu_us << ", \"" << peak_key(phase) << "\": " << phase.peak_rss;
+            out << ", \"allocated_bytes\": " << phase.allocated << ", \"allocations\": " << phase.allocation_count << "}}";
+        }
+        out << "\n]}\n";
+    }
+};
 
 
 int main( int argc, char* argv[] ) {
@@ -20,6 +174,10 @@ int main( int argc, char* argv[] ) {
     bool printgraph=false;
     bool help=false;
     bool fewoutput=false;
+    bool printcounters=false;
+    std::string statspath="";
+    std::string tracepath="";
+    PhaseRecorder recorder;
     auto cli = Catch::clara::Opt( vertex, "vertexid" )
     ["-n"]["--vertex"]
     ("vertex to use")
@@ -32,6 +190,15 @@ int main( int argc, char* argv[] ) {
     | Catch::clara::Opt( printgraph, "printgraph" )
     ["-p"]["--print"]
     ("print graph")
+    | Catch::clara::Opt( printcounters )
+    ["-c"]["--counters"]
+    ("print instrumentation counters (requires build with SFL_COUNTERS)")
+    | Catch::clara::Opt( statspath, "statsfile" )
+    ["-s"]["--stats"]
+    ("write time, cpu time, peak rss and allocations per phase as json")
+    | Catch::clara::Opt( tracepath, "tracefile" )
+    ["-t"]["--trace"]
+    ("write phases in chrome trace format")
     | Catch::clara::Help( help )
     ["-h"]["--help"]
     ("help") // help
@@ -45,6 +212,7 @@ int main( int argc, char* argv[] ) {
     }
 
     // global setup...
+    recorder.begin("load");
     if (graphpath=="") {
         std::cout << "No graph given, fallback to intern" << std::endl;
         SFL_ID_SIZE edges[] = {1,2, 2,3, 3,4, 3,5, 1,3, 1,5, 5,4, 1,6, 8,9, 9,10, 10,8};
@@ -73,6 +241,7 @@ int main( int argc, char* argv[] ) {
         removed.set(removed_vertex, true);
         std::cout << "experimental mode active" << std::endl;
     }
+    recorder.end();
 
     if (printgraph){
         std::cout << "------------------------- graph --------------------------------" << std::endl;
@@ -97,11 +266,16 @@ int main( int argc, char* argv[] ) {
     }
 
     SFLGraph* helpergraph = graph.get();
+    // count only the algorithms
+    counters_reset();
 
+    recorder.begin("annotate_edges");
     annotated_edges_t annotated = annotate_edges(*graph);
     if (removed.ones()>0){
+        recorder.begin("update_edges");
         update_edges(*graph, annotated, removed);
     }
+    recorder.end();
     int64_t level=0;
     if (!fewoutput){
         std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> climb_down = [&level, &annotated, &removed](SFL_ID_SIZE last, SFL_POS_SIZE edge, SFL_ID_SIZE next, uint8_t color) {
@@ -138,6 +312,7 @@ int main( int argc, char* argv[] ) {
                 std::cout << " ";
             std::cout << "post process: " << node << " size: " << size << std::endl;
         };
+        recorder.begin("dfs");
         if (!removed.get(vertex)){
             std::cout << "------------------------- dfs node --------------------------------" << std::endl;
             // O(n) dfs (without parents)
@@ -155,6 +330,7 @@ int main( int argc, char* argv[] ) {
             std::cout << "skip" << std::endl;
         }
     }
+    recorder.begin("cutvertices");
     {
         std::cout << "------------------------- cutvertices --------------------------------" << std::endl;
         // shared ptr would keep reference too long
@@ -174,6 +350,7 @@ int main( int argc, char* argv[] ) {
         std::cout << std::endl;
     }
 
+    recorder.begin("biconnected_components");
     {
         std::cout << "-------------------- biconnected components --------------------------------" << std::endl;
         firstprinted=false;
@@ -211,6 +388,19 @@ int main( int argc, char* argv[] ) {
         std::cout << std::endl;
         level = 0;
     }
+    recorder.end();
+    if (!statspath.empty()){
+        std::ofstream out(statspath);
+        recorder.write_stats(out, graphpath);
+    }
+    if (!tracepath.empty()){
+        std::ofstream out(tracepath);
+        recorder.write_trace(out);
+    }
+    if (printcounters){
+        std::cout << "------------------------- counters --------------------------------" << std::endl;
+        counters_dump(std::cout);
+    }
     if (graphpath=="") {
         std::cout << "Intern test graph finished. Use -h, --help for help" << std::endl;
     }
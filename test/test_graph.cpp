@@ -6,6 +6,9 @@
 #include "../src/commondefinitions.h"
 #include "test_main.hpp"
 #include <sstream>
+#include <algorithm>
+#include <random>
+#include <map>
 //#include <iostream>
 
 TEST_CASE( "Adjacence loading",  "[SFLGraph][adjancence]") {
@@ -53,6 +56,7 @@ TEST_CASE( "Graph basics",  "[SFLGraph][annotated_edges_t]") {
         REQUIRE(local_graph.deg(10) == 0);
         REQUIRE(local_graph.head(1, 1) == 2);
         REQUIRE(local_graph.n() == 10);
+        REQUIRE(local_graph.max_deg() == 4);
 
         annotated_edges_t annotated = annotated_edges_t(local_graph.begin_deg(), local_graph.end_deg(), false, false, array_multi_bit<2>());
         for (size_t node=1; node<=local_graph.n(); node++){
@@ -85,6 +89,169 @@ TEST_CASE( "Graph basics",  "[SFLGraph][annotated_edges_t]") {
         }
     }
 }
+// checks mates, loops and multi edges, returns amount of edges
+static uint64_t check_simple_graph(const SFLGraph &graph){
+    uint64_t sum_deg=0;
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        std::vector<SFL_ID_SIZE> heads;
+        for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            AdjEntry mate_ = graph.mate(node, edge);
+            REQUIRE(std::get<0>(graph.mate(std::get<0>(mate_), std::get<1>(mate_)))==node);
+            REQUIRE(std::get<0>(mate_)!=node);
+            heads.push_back(std::get<0>(mate_));
+        }
+        std::sort(heads.begin(), heads.end());
+        REQUIRE(std::adjacent_find(heads.begin(), heads.end())==heads.end());
+        sum_deg += graph.deg(node);
+    }
+    return sum_deg/2;
+}
+
+TEST_CASE( "Graph generators", "[SFLGraph][generators]") {
+    SECTION("Deterministic topologies"){
+        SFLGraph path = SFLGraph::create_path(100);
+        REQUIRE(check_simple_graph(path)==99);
+        REQUIRE(path.max_deg()==2);
+        SFLGraph cycle = SFLGraph::create_cycle(100);
+        REQUIRE(check_simple_graph(cycle)==100);
+        SFLGraph star = SFLGraph::create_star(100);
+        REQUIRE(check_simple_graph(star)==99);
+        REQUIRE(star.deg(1)==99);
+        SFLGraph grid = SFLGraph::create_grid(5, 7);
+        REQUIRE(grid.n()==35);
+        REQUIRE(check_simple_graph(grid)==2*5*7-5-7);
+        REQUIRE(grid.head(1, 1)==2);
+        REQUIRE(grid.head(1, 2)==8);
+        SFLGraph chain = SFLGraph::create_clique_chain(6, 4);
+        REQUIRE(chain.n()==6*3+1);
+        REQUIRE(check_simple_graph(chain)==6*6);
+        annotated_edges_t annotated = annotate_edges(chain);
+        const RSBitmap cut = cutvertices(chain, annotated);
+        REQUIRE(cut.ones()==5);
+        for (SFL_ID_SIZE clique=1; clique<6; clique++)
+            REQUIRE(cut.get(clique*3+1));
+    }
+    SECTION("Erdos-Renyi"){
+        SFLGraph graph = SFLGraph::create_erdos_renyi(1000, 0.01, 5);
+        uint64_t edges = check_simple_graph(graph);
+        // expected 4995, 5 standard deviations
+        REQUIRE(edges>4995-350);
+        REQUIRE(edges<4995+350);
+        SFLGraph same = SFLGraph::create_erdos_renyi(1000, 0.01, 5);
+        for (SFL_ID_SIZE node=1; node<=graph.n(); node++)
+            REQUIRE(graph.deg(node)==same.deg(node));
+        REQUIRE(check_simple_graph(SFLGraph::create_erdos_renyi(30, 1.0))==30*29/2);
+        REQUIRE(check_simple_graph(SFLGraph::create_erdos_renyi(30, 0.0))==0);
+    }
+    SECTION("R-MAT"){
+        SFLGraph graph = SFLGraph::create_rmat(10, 8, 3);
+        REQUIRE(graph.n()==1024);
+        uint64_t edges = check_simple_graph(graph);
+        REQUIRE(edges>1024);
+        REQUIRE(edges<=1024*8);
+        // skewed degrees
+        REQUIRE(graph.max_deg()>32);
+    }
+    SECTION("Random geometric"){
+        SFLGraph graph = SFLGraph::create_geometric(2000, 0.03, 9);
+        uint64_t edges = check_simple_graph(graph);
+        // expected about n^2/2*pi*r^2 = 5655 minus border effects
+        REQUIRE(edges>4000);
+        REQUIRE(edges<6500);
+        // radius covering everything gives a clique
+        REQUIRE(check_simple_graph(SFLGraph::create_geometric(40, 1.5))==40*39/2);
+    }
+}
+
+// checks that mates point back to the same position and compares the edges with a reference
+static void check_dynamic_graph(const SFLGraph &graph, const std::vector<std::vector<SFL_ID_SIZE>> &reference){
+    REQUIRE(graph.n()==reference.size());
+    SFL_POS_SIZE max_degree=0;
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        CAPTURE(node);
+        std::vector<SFL_ID_SIZE> heads;
+        for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            AdjEntry mate_ = graph.mate(node, edge);
+            REQUIRE(graph.mate(std::get<0>(mate_), std::get<1>(mate_))==AdjEntry(node, edge));
+            heads.push_back(std::get<0>(mate_));
+        }
+        std::sort(heads.begin(), heads.end());
+        std::vector<SFL_ID_SIZE> expected = reference[node-1];
+        std::sort(expected.begin(), expected.end());
+        REQUIRE(heads==expected);
+        max_degree = std::max(max_degree, graph.deg(node));
+    }
+    REQUIRE(graph.max_deg()==max_degree);
+}
+
+TEST_CASE( "Dynamic graph updates", "[SFLGraph][dynamic]") {
+    SFLGraph graph = SFLGraph::create_cycle(5);
+    std::vector<std::vector<SFL_ID_SIZE>> reference = {{2, 5}, {1, 3}, {2, 4}, {3, 5}, {4, 1}};
+    REQUIRE(graph.add_node()==6);
+    reference.emplace_back();
+    REQUIRE(graph.add_edge(6, 1)==1);
+    reference[5].push_back(1);
+    reference[0].push_back(6);
+    check_dynamic_graph(graph, reference);
+    REQUIRE_THROWS(graph.add_edge(6, 6));
+    REQUIRE_THROWS(graph.add_edge(6, 7));
+    REQUIRE_THROWS(graph.remove_edge(6, 2));
+    // first edge of node 1 is replaced by its last edge (to 6)
+    graph.remove_edge(1, 1);
+    REQUIRE(graph.head(1, 1)==6);
+    REQUIRE(graph.find_edge(1, 2)==0);
+    reference[0] = {5, 6};
+    reference[1] = {3};
+    check_dynamic_graph(graph, reference);
+    REQUIRE(graph.node(1).edges.size()==2);
+    // missing edge in batch
+    REQUIRE_THROWS(graph.apply({{1, 2, true}}));
+
+    std::mt19937_64 gen(7);
+    for (int round=0; round<200; round++){
+        std::vector<edge_update> updates;
+        for (int count=0; count<20; count++){
+            SFL_ID_SIZE node1 = gen()%graph.n()+1;
+            SFL_ID_SIZE node2 = gen()%graph.n()+1;
+            if (gen()%3==0 && !reference[node1-1].empty()){
+                // remove an existing edge
+                node2 = reference[node1-1][gen()%reference[node1-1].size()];
+                updates.push_back({node1, node2, true});
+                reference[node1-1].erase(std::find(reference[node1-1].begin(), reference[node1-1].end(), node2));
+                reference[node2-1].erase(std::find(reference[node2-1].begin(), reference[node2-1].end(), node1));
+            } else if (node1!=node2 && std::find(reference[node1-1].begin(), reference[node1-1].end(), node2)==reference[node1-1].end()){
+                updates.push_back({node1, node2, false});
+                reference[node1-1].push_back(node2);
+                reference[node2-1].push_back(node1);
+            }
+        }
+        if (round%2){
+            graph.apply(updates);
+        } else {
+            for (const edge_update &update: updates){
+                if (update.remove)
+                    graph.remove_edge(update.node1, graph.find_edge(update.node1, update.node2));
+                else
+                    graph.add_edge(update.node1, update.node2);
+            }
+        }
+        if (round%10==0){
+            graph.add_node();
+            reference.emplace_back();
+        }
+        check_dynamic_graph(graph, reference);
+    }
+    // derived structures work on the updated graph
+    uint64_t half_edges=0;
+    for (const auto &heads: reference)
+        half_edges += heads.size();
+    annotated_edges_t annotated = annotate_edges(graph);
+    REQUIRE(annotated.size()==half_edges);
+    SFLGraph copied = SFLGraph::copy_from(graph);
+    annotated_edges_t annotated_copy = annotate_edges(copied);
+    REQUIRE(cutvertices(graph, annotated).ones()==cutvertices(copied, annotated_copy).ones());
+}
+
 TEST_CASE( "Depth first search", "[dfs]" ) {
     std::shared_ptr<SFLGraph> local_graph;
     int64_t stack_level=0;
@@ -144,6 +311,124 @@ TEST_CASE( "Depth first search", "[dfs]" ) {
     dfs(*local_graph, 0, climb_down, climb_up, pre_processing);
 #endif
 }
+TEST_CASE( "Depth first search workspace", "[dfs][DfsWorkspace]" ) {
+    std::vector<std::tuple<SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE>> events;
+    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> climb_down = [&events](SFL_ID_SIZE last, SFL_POS_SIZE edge, SFL_ID_SIZE next, uint8_t color) {
+        events.emplace_back(last, edge, next);
+        return true;
+    };
+    std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> pre_processing = [&events](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
+        events.emplace_back(node, size, 0);
+        return true;
+    };
+    std::vector<SFLGraph> graphs;
+    graphs.push_back(SFLGraph::create(16, graph3_edges, 20));
+    graphs.push_back(SFLGraph::create_star(300));
+    graphs.push_back(SFLGraph::create_clique_chain(20, 4));
+    for (const SFLGraph &local_graph: graphs){
+        CAPTURE(local_graph.n());
+        annotated_edges_t annotated = annotate_edges(local_graph);
+        DfsWorkspace workspace(local_graph);
+        REQUIRE(workspace.space_report().total()>0);
+        for (SFL_ID_SIZE vertex: {SFL_ID_SIZE(1), SFL_ID_SIZE(2), SFL_ID_SIZE(0), SFL_ID_SIZE(2)}){
+            CAPTURE(vertex);
+            events.clear();
+            dfs(local_graph, vertex, climb_down, dfs_placeholder, pre_processing);
+            auto expected = events;
+            events.clear();
+            dfs(local_graph, workspace, vertex, climb_down, dfs_placeholder, pre_processing);
+            REQUIRE(events==expected);
+
+            events.clear();
+            dfs(local_graph, annotated, vertex, climb_down, dfs_placeholder, pre_processing);
+            expected = events;
+            events.clear();
+            dfs(local_graph, annotated, workspace, vertex, climb_down, dfs_placeholder, pre_processing);
+            REQUIRE(events==expected);
+        }
+        SFLGraph other = SFLGraph::create_path(local_graph.n()+1);
+        CHECK_THROWS(dfs(other, workspace));
+    }
+    // reuse after the maximal degree grew
+    SFLGraph path = SFLGraph::create_path(64);
+    DfsWorkspace workspace(path);
+    dfs(path, workspace);
+    for (SFL_ID_SIZE node=3; node<=14; node++)
+        path.add_edge(1, node);
+    REQUIRE(path.max_deg()==13);
+    REQUIRE(workspace.max_edge()==3);
+    events.clear();
+    dfs(path, 0, climb_down, dfs_placeholder, pre_processing);
+    auto expected = events;
+    events.clear();
+    dfs(path, workspace, 0, climb_down, dfs_placeholder, pre_processing);
+    REQUIRE(events==expected);
+    REQUIRE(workspace.max_edge()==14);
+}
+TEST_CASE( "Pull-style depth first search", "[dfs][DfsEvents]" ) {
+    std::vector<std::shared_ptr<SFLGraph>> graphs;
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(10, graph1_edges, 9)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(9, graph2_edges, 11)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(16, graph3_edges, 20)));
+#ifdef USE_BOOST
+    std::stringstream oldgraph_stream(oldgraph, std::ios::in);
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_from_dot(oldgraph_stream)));
+#endif
+    for (auto &local_graph: graphs){
+        for (SFL_ID_SIZE vertex: {0, 1}){
+            CAPTURE(local_graph->n());
+            CAPTURE(vertex);
+            // reference events from the push-style dfs
+            std::vector<std::tuple<int, SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE>> expected;
+            std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, SFL_ID_SIZE, uint8_t)> climb_down = [&expected](SFL_ID_SIZE last, SFL_POS_SIZE edge, SFL_ID_SIZE next, uint8_t color) {
+                if (color==white)
+                    expected.emplace_back(dfs_tree_edge, last, edge, next);
+                else if (color!=black)
+                    expected.emplace_back(dfs_back_edge, last, edge, next);
+                return true;
+            };
+            std::function<bool (SFL_ID_SIZE, SFL_POS_SIZE, bool)> pre_processing = [&expected](SFL_ID_SIZE node, SFL_POS_SIZE size, bool is_root) {
+                expected.emplace_back(dfs_enter, node, size, is_root);
+                return true;
+            };
+            std::function<void (SFL_ID_SIZE, SFL_POS_SIZE)> post_processing = [&expected](SFL_ID_SIZE node, SFL_POS_SIZE size) {
+                expected.emplace_back(dfs_leave, node, size, 0);
+            };
+            dfs(*local_graph, vertex, climb_down, dfs_placeholder, pre_processing, post_processing);
+
+            DfsEvents events(*local_graph, vertex);
+            size_t counter=0;
+            for (const dfs_event &event: events){
+                CAPTURE(counter);
+                REQUIRE(counter<expected.size());
+                REQUIRE(std::get<0>(expected[counter])==event.type);
+                REQUIRE(std::get<1>(expected[counter])==event.node);
+                REQUIRE(std::get<2>(expected[counter])==event.edge);
+                if (event.type==dfs_enter)
+                    REQUIRE(std::get<3>(expected[counter])==event.is_root);
+                else
+                    REQUIRE(std::get<3>(expected[counter])==event.next);
+                counter++;
+            }
+            REQUIRE(counter==expected.size());
+        }
+    }
+    SECTION("early stop"){
+        SFLGraph local_graph = SFLGraph::create(16, graph3_edges, 20);
+        DfsEvents events(local_graph, 3);
+        dfs_event event;
+        uint64_t entered=0;
+        while(events.next(event)){
+            if (event.type==dfs_enter)
+                entered++;
+            if (event.type==dfs_back_edge)
+                break;
+        }
+        REQUIRE(entered>0);
+        REQUIRE(entered<local_graph.n());
+    }
+}
+
 TEST_CASE( "Annotation algorithms", "[annotate_edges][annotate_links]") {
     SFLGraph local_graph = SFLGraph::create(9, graph1_edges, 9);
     annotated_edges_t annotated = annotate_edges(local_graph);
@@ -180,6 +465,118 @@ TEST_CASE( "Annotation algorithms", "[annotate_edges][annotate_links]") {
     };
     dfs(local_graph, 0, climb_down, dfs_placeholder, pre_processing);
     REQUIRE(test_single.ones()+std::get<edges_parent>(annotated.arrays).ones()==test_single.n());
+
+    space_summary summary = annotation_space(local_graph, annotated);
+    REQUIRE(summary.bytes==annotated.memory_usage());
+    REQUIRE(summary.bytes>0);
+    REQUIRE(summary.bits_per_node==Approx(8.0*summary.bytes/9));
+    REQUIRE(summary.bits_per_edge==Approx(8.0*summary.bytes/9));
+}
+
+TEST_CASE( "Connected components", "[connected_components]") {
+    SFLGraph local_graph = SFLGraph::create(10, graph1_edges, 9);
+    std::vector<std::vector<SFL_ID_SIZE>> components;
+    std::function<void (SFL_ID_SIZE, bool)> output_func = [&components](SFL_ID_SIZE node, bool new_component) {
+        if (new_component)
+            components.emplace_back();
+        components.back().push_back(node);
+    };
+    REQUIRE(connected_components(local_graph, output_func)==3);
+    REQUIRE(components.size()==3);
+    REQUIRE(components[0].size()==7);
+    REQUIRE(components[0][0]==1);
+    REQUIRE(components[1].size()==2);
+    REQUIRE(components[1][0]==7);
+    REQUIRE(components[2].size()==1);
+    REQUIRE(components[2][0]==10);
+
+    const BitPackedArray& labels = connected_components(local_graph);
+    REQUIRE(labels.width()==2);
+    for (SFL_ID_SIZE node : {1, 2, 3, 4, 5, 6, 9}){
+        CAPTURE(node);
+        REQUIRE(labels.get(node)==1);
+    }
+    REQUIRE(labels.get(7)==2);
+    REQUIRE(labels.get(8)==2);
+    REQUIRE(labels.get(10)==3);
+
+    // removing the articulation point 3 splits the first component
+    RSBitmap removed(local_graph.n());
+    removed.set(3, true);
+    const BitPackedArray& labels_removed = connected_components(local_graph, removed);
+    REQUIRE(labels_removed.get(3)==0);
+    REQUIRE(labels_removed.get(1)==1);
+    REQUIRE(labels_removed.get(2)==1);
+    REQUIRE(labels_removed.get(9)==1);
+    REQUIRE(labels_removed.get(4)==2);
+    REQUIRE(labels_removed.get(6)==2);
+    REQUIRE(labels_removed.get(7)==3);
+    REQUIRE(labels_removed.get(10)==4);
+
+    SFLGraph local_graph3 = SFLGraph::create(16, graph3_edges, 20);
+    REQUIRE(connected_components(local_graph3, [](SFL_ID_SIZE, bool){})==1);
+}
+
+TEST_CASE( "Fused traversal", "[FusedTraversal]") {
+    SFLGraph local_graph = SFLGraph::create(10, graph1_edges, 9);
+    // reference with separate searches
+    annotated_edges_t reference = annotate_edges(local_graph);
+
+    annotated_edges_t annotated(local_graph.begin_deg(), local_graph.end_deg(), false, false, array_multi_bit<2>());
+    degree_stats stats;
+    uint64_t components=0;
+    std::vector<SFL_ID_SIZE> roots;
+    std::function<void (SFL_ID_SIZE, bool)> output_func = [&roots](SFL_ID_SIZE node, bool new_component) {
+        if (new_component)
+            roots.push_back(node);
+    };
+    FusedTraversal fused;
+    fused.add(annotate_visitor(local_graph, annotated));
+    fused.add(mark_visitor(local_graph, annotated, std::get<edge_marks>(annotated.arrays)));
+    fused.add(degree_visitor(stats));
+    fused.add(components_visitor(components, output_func));
+    REQUIRE(fused.analyses()==4);
+    fused_report report = fused.run(local_graph, annotated);
+    REQUIRE(report.analyses==4);
+    REQUIRE(report.passes==2);
+    REQUIRE(report.passes_saved==2);
+
+    REQUIRE(components==3);
+    REQUIRE(roots==std::vector<SFL_ID_SIZE>({1, 7, 10}));
+    REQUIRE(stats.nodes==10);
+    REQUIRE(stats.isolated==1);
+    REQUIRE(stats.min_deg==0);
+    REQUIRE(stats.max_deg==4);
+    REQUIRE(stats.sum_deg==18);
+    for(uint64_t pos=1; pos<=annotated.size(); pos++){
+        CAPTURE(pos);
+        REQUIRE(annotated.get<edges_parent>(pos)==reference.get<edges_parent>(pos));
+        REQUIRE(annotated.get<edges_backlink>(pos)==reference.get<edges_backlink>(pos));
+        REQUIRE(annotated.get<edge_marks>(pos)==reference.get<edge_marks>(pos));
+    }
+    REQUIRE(std::get<edges_parent>(annotated.arrays).is_static());
+
+    SECTION( "Single analysis" ) {
+        degree_stats stats_single;
+        FusedTraversal single;
+        single.add(degree_visitor(stats_single));
+        fused_report report_single = single.run(local_graph);
+        REQUIRE(report_single.passes==1);
+        REQUIRE(report_single.passes_saved==0);
+        REQUIRE(stats_single.sum_deg==stats.sum_deg);
+    }
+    SECTION( "Rejecting visitors hide nodes" ) {
+        RSBitmap removed(local_graph.n());
+        removed.set(3, true);
+        degree_stats stats_removed;
+        uint64_t components_removed=0;
+        FusedTraversal filtered;
+        filtered.add(components_visitor(components_removed, [](SFL_ID_SIZE, bool){}, removed));
+        filtered.add(degree_visitor(stats_removed));
+        filtered.run(local_graph);
+        REQUIRE(components_removed==4);
+        REQUIRE(stats_removed.nodes==9);
+    }
 }
 
 TEST_CASE( "Cutvertice search", "[cutvertices]") {
@@ -250,6 +647,150 @@ TEST_CASE( "Bi-connected component search", "[twice_cc]" ) {
     annotated_edges_t annotated = annotate_edges(*local_graph);
     REQUIRE(annotated.segments()==local_graph->n());
     const std::vector<std::vector<SFL_ID_SIZE>>& cc_res = biconnected_components(*local_graph, annotated);
+    SECTION("known blocks"){
+        // two triangles sharing node 3, a back edge from the second one reaches the first one's cut vertex
+        const SFL_ID_SIZE triangles_edges[] = {1,2, 2,3, 3,1, 3,4, 4,5, 5,3};
+        SFLGraph triangles = SFLGraph::create(5, triangles_edges, 6);
+        annotated_edges_t triangles_annotated = annotate_edges(triangles);
+        std::vector<std::vector<SFL_ID_SIZE>> blocks = biconnected_components(triangles, triangles_annotated);
+        for (auto &block: blocks)
+            std::sort(block.begin(), block.end());
+        std::sort(blocks.begin(), blocks.end());
+        REQUIRE(blocks==std::vector<std::vector<SFL_ID_SIZE>>({{1, 2, 3}, {3, 4, 5}}));
+
+        SFLGraph chain = SFLGraph::create_clique_chain(50, 5);
+        annotated_edges_t chain_annotated = annotate_edges(chain);
+        blocks = biconnected_components(chain, chain_annotated);
+        REQUIRE(blocks.size()==50);
+        for (const auto &block: blocks)
+            REQUIRE(block.size()==5);
+        REQUIRE(cutvertices(chain, chain_annotated).ones()==49);
+    }
+    SECTION("compact labels"){
+        for (uint64_t seed=1; seed<=10; seed++){
+            CAPTURE(seed);
+            SFLGraph random_graph = SFLGraph::create_erdos_renyi(300, 2.0/300, seed);
+            annotated_edges_t random_annotated = annotate_edges(random_graph);
+            std::vector<std::vector<SFL_ID_SIZE>> blocks = biconnected_components(random_graph, random_annotated);
+            const BlockLabels labels = biconnected_labels(random_graph, random_annotated);
+            REQUIRE(labels.blocks()==blocks.size());
+            // collect members from the labels
+            std::vector<std::vector<SFL_ID_SIZE>> from_labels(labels.blocks());
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+                if (labels.block(node)>0)
+                    from_labels[labels.block(node)-1].push_back(node);
+                for (uint64_t pos=1; pos<=labels.top_blocks(node); pos++)
+                    from_labels[labels.top_block(node, pos)-1].push_back(node);
+            }
+            for (auto &block: blocks)
+                std::sort(block.begin(), block.end());
+            for (auto &block: from_labels)
+                std::sort(block.begin(), block.end());
+            std::sort(blocks.begin(), blocks.end());
+            std::sort(from_labels.begin(), from_labels.end());
+            REQUIRE(blocks==from_labels);
+            // edges are in a block with both ends, bridges separate blocks
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+                for (SFL_POS_SIZE edge=1; edge<=random_graph.deg(node); edge++){
+                    SFL_ID_SIZE next = random_graph.head(node, edge);
+                    uint64_t block = labels.block_of_edge(random_graph, node, edge);
+                    CAPTURE(node);
+                    CAPTURE(next);
+                    AdjEntry mate_ = random_graph.mate(node, edge);
+                    REQUIRE(block==labels.block_of_edge(random_graph, std::get<0>(mate_), std::get<1>(mate_)));
+                    if (block>0){
+                        REQUIRE(labels.contains(node, block));
+                        REQUIRE(labels.contains(next, block));
+                    } else {
+                        // a bridge, no block contains both ends
+                        for (uint64_t other=1; other<=labels.blocks(); other++)
+                            REQUIRE(!(labels.contains(node, other) && labels.contains(next, other)));
+                    }
+                }
+            }
+            BlockLabels copied = labels.copy();
+            REQUIRE(copied.blocks()==labels.blocks());
+            REQUIRE(labels.space_report().total()==labels.memory_usage());
+        }
+        // label width grows with the amount of blocks, not with the graph
+        SFLGraph chain = SFLGraph::create_clique_chain(3, 40);
+        annotated_edges_t chain_annotated = annotate_edges(chain);
+        const BlockLabels labels = biconnected_labels(chain, chain_annotated);
+        REQUIRE(labels.blocks()==3);
+        for (const auto &component: labels.space_report().components){
+            if (component.first=="labels.array")
+                REQUIRE(component.second==(chain.n()*2+63)/64*8);
+        }
+    }
+    SECTION("compare with lowpoints"){
+        // sparse random graphs with many blocks and bridges, without and with removed nodes
+        for (uint64_t seed=1; seed<=40; seed++){
+            CAPTURE(seed);
+            // removed nodes inside the many small blocks of geometric graphs
+            SFLGraph random_graph = seed%2==0 ? SFLGraph::create_geometric(200, 0.1, seed/2) : SFLGraph::create_erdos_renyi(200, 1.5/200, (seed+1)/2);
+            RSBitmap removed(random_graph.n());
+            if (seed%2==0){
+                for (uint64_t counter=1; counter<=3; counter++)
+                    removed.set((seed*counter*37)%random_graph.n()+1, true);
+            }
+            annotated_edges_t random_annotated = annotate_edges(random_graph, removed);
+            // reference: recursive lowpoint algorithm, blocks with at least 3 nodes (no bridges)
+            std::vector<uint64_t> disc(random_graph.n()+1, 0), low(random_graph.n()+1, 0);
+            std::vector<std::pair<SFL_ID_SIZE, SFL_ID_SIZE>> edge_stack;
+            std::vector<std::vector<SFL_ID_SIZE>> expected;
+            std::vector<bool> expected_cut(random_graph.n()+1, false);
+            uint64_t time=0;
+            std::function<void (SFL_ID_SIZE, SFL_ID_SIZE)> visit = [&](SFL_ID_SIZE node, SFL_ID_SIZE parent){
+                disc[node] = low[node] = ++time;
+                uint64_t children=0;
+                for (SFL_POS_SIZE edge=1; edge<=random_graph.deg(node); edge++){
+                    SFL_ID_SIZE next = random_graph.head(node, edge);
+                    if (removed.get(next))
+                        continue;
+                    if (disc[next]==0){
+                        edge_stack.emplace_back(node, next);
+                        children++;
+                        visit(next, node);
+                        low[node] = std::min(low[node], low[next]);
+                        if (low[next]>=disc[node]){
+                            if (parent!=0 || children>1)
+                                expected_cut[node] = true;
+                            std::vector<SFL_ID_SIZE> block;
+                            std::pair<SFL_ID_SIZE, SFL_ID_SIZE> top;
+                            do {
+                                top = edge_stack.back();
+                                edge_stack.pop_back();
+                                block.push_back(top.first);
+                                block.push_back(top.second);
+                            } while(top!=std::make_pair(node, next));
+                            std::sort(block.begin(), block.end());
+                            block.erase(std::unique(block.begin(), block.end()), block.end());
+                            if (block.size()>=3)
+                                expected.push_back(block);
+                        }
+                    } else if (next!=parent && disc[next]<disc[node]){
+                        edge_stack.emplace_back(node, next);
+                        low[node] = std::min(low[node], disc[next]);
+                    }
+                }
+            };
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+                if (disc[node]==0 && !removed.get(node))
+                    visit(node, 0);
+            }
+            const RSBitmap cut = cutvertices(random_graph, random_annotated, removed);
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+                CAPTURE(node);
+                REQUIRE(cut.get(node)==expected_cut[node]);
+            }
+            std::vector<std::vector<SFL_ID_SIZE>> blocks = biconnected_components(random_graph, random_annotated, removed);
+            for (auto &block: blocks)
+                std::sort(block.begin(), block.end());
+            std::sort(blocks.begin(), blocks.end());
+            std::sort(expected.begin(), expected.end());
+            REQUIRE(blocks==expected);
+        }
+    }
 
 
     /**bool firstprinted=false;
@@ -268,3 +809,419 @@ TEST_CASE( "Bi-connected component search", "[twice_cc]" ) {
         std::cout << std::endl;
     }*/
 }
+
+TEST_CASE( "Chain decomposition", "[chains]" ) {
+    SECTION("known graphs"){
+        const SFL_ID_SIZE triangles_edges[] = {1,2, 2,3, 3,1, 3,4, 4,5, 5,3};
+        SFLGraph triangles = SFLGraph::create(5, triangles_edges, 6);
+        annotated_edges_t annotated = annotate_edges(triangles);
+        const std::vector<dfs_chain> chains = chain_decomposition(triangles, annotated);
+        REQUIRE(chains.size()==2);
+        REQUIRE(chains[0].cycle());
+        REQUIRE(chains[0].length==3);
+        connectivity_certificate certificate = chain_certificate(triangles, annotated);
+        REQUIRE(certificate.cycles==2);
+        REQUIRE(certificate.bridges==0);
+        REQUIRE(certificate.cut_vertex==3);
+        REQUIRE(certificate.two_edge_connected);
+        REQUIRE(!certificate.two_vertex_connected);
+
+        SFLGraph grid = SFLGraph::create_grid(5, 7);
+        certificate = chain_certificate(grid, annotate_edges(grid));
+        REQUIRE(certificate.chains==2*5*7-5-7-5*7+1);
+        REQUIRE(certificate.cycles==1);
+        REQUIRE(certificate.two_vertex_connected);
+
+        SFLGraph path = SFLGraph::create_path(10);
+        certificate = chain_certificate(path, annotate_edges(path));
+        REQUIRE(certificate.chains==0);
+        REQUIRE(certificate.bridges==9);
+        REQUIRE(certificate.bridge_node>0);
+        REQUIRE(certificate.cut_vertex>1);
+        REQUIRE(certificate.cut_vertex<10);
+        REQUIRE(!certificate.two_edge_connected);
+
+        // removing a node of a cycle leaves a path
+        SFLGraph cycle = SFLGraph::create_cycle(10);
+        RSBitmap removed(10);
+        removed.set(4, true);
+        certificate = chain_certificate(cycle, annotate_edges(cycle, removed), removed);
+        REQUIRE(certificate.nodes==9);
+        REQUIRE(certificate.bridges==8);
+        REQUIRE(chain_certificate(cycle, annotate_edges(cycle)).two_vertex_connected);
+    }
+    SECTION("compare with blocks"){
+        for (uint64_t seed=1; seed<=20; seed++){
+            CAPTURE(seed);
+            SFLGraph random_graph = SFLGraph::create_erdos_renyi(200, 2.5/200, seed);
+            annotated_edges_t annotated = annotate_edges(random_graph);
+            const BlockLabels labels = biconnected_labels(random_graph, annotated);
+            const RSBitmap cut = cutvertices(random_graph, annotated);
+            // every edge of a block is in exactly one chain, bridges in none
+            std::vector<std::vector<uint64_t>> in_chain(random_graph.n());
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++)
+                in_chain[node-1].resize(random_graph.deg(node), 0);
+            uint64_t chains = chain_decomposition(random_graph, annotated, [&](const dfs_chain &chain){
+                uint64_t length=0;
+                chain_edges(random_graph, annotated, chain, [&](SFL_ID_SIZE node, SFL_POS_SIZE edge){
+                    AdjEntry mate_ = random_graph.mate(node, edge);
+                    in_chain[node-1][edge-1]++;
+                    in_chain[std::get<0>(mate_)-1][std::get<1>(mate_)-1]++;
+                    length++;
+                });
+                REQUIRE(length==chain.length);
+            });
+            uint64_t edges=0, bridges=0;
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+                for (SFL_POS_SIZE edge=1; edge<=random_graph.deg(node); edge++){
+                    CAPTURE(node);
+                    CAPTURE(edge);
+                    bool bridge = labels.block_of_edge(random_graph, node, edge)==0;
+                    REQUIRE(in_chain[node-1][edge-1]==(bridge ? 0 : 1));
+                    edges++;
+                    bridges += bridge;
+                }
+            }
+            const connectivity_certificate certificate = chain_certificate(random_graph, annotated);
+            // one chain per back edge
+            REQUIRE(chains==edges/2-random_graph.n()+certificate.components);
+            REQUIRE(certificate.chains==chains);
+            REQUIRE(certificate.bridges==bridges/2);
+            REQUIRE((certificate.cut_vertex!=0)==(cut.ones()>0));
+            if (certificate.cut_vertex!=0)
+                REQUIRE(cut.get(certificate.cut_vertex));
+        }
+    }
+}
+
+#ifdef USE_BOOST
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/boyer_myrvold_planar_test.hpp>
+#include <random>
+#include <set>
+// outerplanar if planar with an extra node adjacent to all nodes
+static bool outerplanar_by_apex(const SFLGraph &graph){
+    typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS,
+        boost::property<boost::vertex_index_t, int>, boost::property<boost::edge_index_t, int>> boost_graph_t;
+    boost_graph_t boost_graph(graph.n()+1);
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        boost::add_edge(0, node, boost_graph);
+        for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            if (graph.head(node, edge)>node)
+                boost::add_edge(node, graph.head(node, edge), boost_graph);
+        }
+    }
+    return boost::boyer_myrvold_planarity_test(boost_graph);
+}
+
+// maximal outerplanar graph by adding nodes to outer edges, then some edges are dropped and some random ones are added
+static SFLGraph random_outerplanar(const SFL_ID_SIZE n, const double keep, const uint64_t extra, const uint64_t seed){
+    std::mt19937_64 gen(seed);
+    std::vector<std::pair<SFL_ID_SIZE, SFL_ID_SIZE>> outer = {{1, 2}, {2, 3}, {3, 1}};
+    std::set<std::pair<SFL_ID_SIZE, SFL_ID_SIZE>> edges(outer.begin(), outer.end());
+    for (SFL_ID_SIZE node=4; node<=n; node++){
+        size_t pick = std::uniform_int_distribution<size_t>(0, outer.size()-1)(gen);
+        std::pair<SFL_ID_SIZE, SFL_ID_SIZE> split = outer[pick];
+        outer[pick] = {split.first, node};
+        outer.push_back({node, split.second});
+        edges.insert({split.first, node});
+        edges.insert({split.second, node});
+    }
+    std::vector<SFL_ID_SIZE> ids(n);
+    for (SFL_ID_SIZE node=1; node<=n; node++)
+        ids[node-1] = node;
+    std::shuffle(ids.begin(), ids.end(), gen);
+    std::bernoulli_distribution keep_dist(keep);
+    std::uniform_int_distribution<SFL_ID_SIZE> node_dist(1, n);
+    for (uint64_t counter=0; counter<extra; counter++){
+        SFL_ID_SIZE node1 = node_dist(gen), node2 = node_dist(gen);
+        if (node1!=node2)
+            edges.insert({std::min(node1, node2), std::max(node1, node2)});
+    }
+    std::set<std::pair<SFL_ID_SIZE, SFL_ID_SIZE>> mapped;
+    for (const auto &edge: edges){
+        if (keep_dist(gen))
+            mapped.insert({std::min(ids[edge.first-1], ids[edge.second-1]), std::max(ids[edge.first-1], ids[edge.second-1])});
+    }
+    std::vector<SFL_ID_SIZE> flat;
+    for (const auto &edge: mapped){
+        flat.push_back(edge.first);
+        flat.push_back(edge.second);
+    }
+    return SFLGraph::create(n, flat.data(), mapped.size());
+}
+#endif
+
+TEST_CASE( "Outerplanarity", "[outerplanar]" ) {
+    SECTION("known graphs"){
+        auto outerplanar = [](const SFLGraph &graph){
+            return is_outerplanar(graph, annotate_edges(graph));
+        };
+        REQUIRE(outerplanar(SFLGraph::create_path(20)));
+        REQUIRE(outerplanar(SFLGraph::create_star(20)));
+        REQUIRE(outerplanar(SFLGraph::create_cycle(20)));
+        REQUIRE(outerplanar(SFLGraph::create_grid(2, 20)));
+        REQUIRE(!outerplanar(SFLGraph::create_grid(3, 3)));
+        REQUIRE(outerplanar(SFLGraph::create_clique_chain(10, 3)));
+        REQUIRE(!outerplanar(SFLGraph::create_clique_chain(10, 4)));
+        // K_2,3
+        const SFL_ID_SIZE k23_edges[] = {1,3, 1,4, 1,5, 2,3, 2,4, 2,5};
+        REQUIRE(!outerplanar(SFLGraph::create(5, k23_edges, 6)));
+        // fan: path with an extra node adjacent to all
+        const SFL_ID_SIZE fan_edges[] = {1,2, 2,3, 3,4, 4,5, 6,1, 6,2, 6,3, 6,4, 6,5};
+        SFLGraph fan = SFLGraph::create(6, fan_edges, 9);
+        annotated_edges_t annotated = annotate_edges(fan);
+        REQUIRE(is_outerplanar(fan, annotated));
+        // removing a node of K_2,3 leaves a cycle
+        SFLGraph k23 = SFLGraph::create(5, k23_edges, 6);
+        RSBitmap removed(5);
+        removed.set(5, true);
+        REQUIRE(is_outerplanar(k23, annotate_edges(k23, removed), removed));
+        // only the second block fails
+        const SFL_ID_SIZE mixed_edges[] = {1,2, 2,3, 3,1, 3,4, 3,5, 3,6, 4,5, 4,6, 5,6};
+        SFLGraph mixed = SFLGraph::create(6, mixed_edges, 9);
+        std::vector<bool> results;
+        REQUIRE(outerplanar_blocks(mixed, annotate_edges(mixed), [&results](uint64_t block, bool outerplanar){
+            REQUIRE(block==results.size()+1);
+            results.push_back(outerplanar);
+        })==1);
+        std::sort(results.begin(), results.end());
+        REQUIRE(results==std::vector<bool>({false, true}));
+    }
+#ifdef USE_BOOST
+    SECTION("compare with planarity"){
+        uint64_t positive=0;
+        for (uint64_t seed=1; seed<=200; seed++){
+            CAPTURE(seed);
+            SFLGraph random_graph = random_outerplanar(30+seed%50, seed%3 ? 0.9 : 1.0, seed%4, seed);
+            bool expected = outerplanar_by_apex(random_graph);
+            positive += expected;
+            REQUIRE(is_outerplanar(random_graph, annotate_edges(random_graph))==expected);
+        }
+        // both outcomes are tested
+        REQUIRE(positive>20);
+        REQUIRE(positive<180);
+    }
+#endif
+}
+
+// st-numbering is a permutation, s and t are adjacent and every other node has a lower and a higher neighbor
+static void check_st_numbering(const SFLGraph &graph, const BitPackedArray &numbering){
+    std::vector<bool> used(graph.n()+1, false);
+    SFL_ID_SIZE s=0, t=0;
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        CAPTURE(node);
+        uint64_t number = numbering.get(node);
+        REQUIRE(number>=1);
+        REQUIRE(number<=graph.n());
+        REQUIRE(!used[number]);
+        used[number] = true;
+        if (number==1)
+            s = node;
+        if (number==graph.n())
+            t = node;
+        bool lower=false, higher=false;
+        for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+            lower |= numbering.get(graph.head(node, edge))<number;
+            higher |= numbering.get(graph.head(node, edge))>number;
+        }
+        if (number!=1)
+            REQUIRE(lower);
+        if (number!=graph.n())
+            REQUIRE(higher);
+    }
+    REQUIRE(find_pos_for_id(graph, s, t)!=0);
+}
+
+TEST_CASE( "st-numbering and open ear decomposition", "[chains][st_numbering]" ) {
+    std::vector<std::shared_ptr<SFLGraph>> graphs;
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_cycle(3)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_cycle(30)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_grid(6, 9)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_erdos_renyi(40, 1.0)));
+    for (uint64_t seed=1; seed<=20; seed++){
+        SFLGraph random_graph = SFLGraph::create_erdos_renyi(150, 8.0/150, seed);
+        if (chain_certificate(random_graph, annotate_edges(random_graph)).two_vertex_connected)
+            graphs.push_back(std::make_shared<SFLGraph>(std::move(random_graph)));
+    }
+    REQUIRE(graphs.size()>10);
+    for (auto &local_graph: graphs){
+        CAPTURE(local_graph->n());
+        annotated_edges_t annotated = annotate_edges(*local_graph);
+        check_st_numbering(*local_graph, st_numbering(*local_graph, annotated));
+        // every ear after the first one connects two different nodes of earlier ears
+        std::vector<bool> in_ear(local_graph->n()+1, false);
+        uint64_t edges=0, ears = open_ear_decomposition(*local_graph, annotated, [&](const dfs_chain &ear){
+            if (edges==0){
+                REQUIRE(ear.cycle());
+            } else {
+                REQUIRE(!ear.cycle());
+                REQUIRE(in_ear[ear.node]);
+                REQUIRE(in_ear[ear.end]);
+            }
+            chain_edges(*local_graph, annotated, ear, [&](SFL_ID_SIZE node, SFL_POS_SIZE edge){
+                in_ear[node] = true;
+                in_ear[local_graph->head(node, edge)] = true;
+                edges++;
+            });
+        });
+        uint64_t sum_deg=0;
+        for (SFL_ID_SIZE node=1; node<=local_graph->n(); node++)
+            sum_deg += local_graph->deg(node);
+        REQUIRE(edges==sum_deg/2);
+        REQUIRE(ears==sum_deg/2-local_graph->n()+1);
+    }
+    SFLGraph chain = SFLGraph::create_clique_chain(3, 4);
+    annotated_edges_t annotated = annotate_edges(chain);
+    REQUIRE_THROWS(st_numbering(chain, annotated));
+    REQUIRE_THROWS(open_ear_decomposition(chain, annotated, [](const dfs_chain&){}));
+    SFLGraph path = SFLGraph::create_path(5);
+    REQUIRE_THROWS(st_numbering(path, annotate_edges(path)));
+}
+
+TEST_CASE( "Spanning forest", "[spanning_forest]" ) {
+    for (uint64_t seed=1; seed<=10; seed++){
+        CAPTURE(seed);
+        SFLGraph random_graph = SFLGraph::create_erdos_renyi(300, 1.5/300, seed);
+        annotated_edges_t annotated = annotate_edges(random_graph);
+        const RSBitmap forest = spanning_forest(random_graph, annotated);
+        REQUIRE(forest.is_static());
+        uint64_t components = connected_components(random_graph, [](SFL_ID_SIZE, bool){});
+        REQUIRE(forest.ones()==2*(random_graph.n()-components));
+        const ForestCSR csr(random_graph, forest);
+        uint64_t children=0;
+        for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+            CAPTURE(node);
+            SFL_POS_SIZE parent_edge = annotated.segment_size(node)>0 ? annotated.select_segment_pos(std::get<edges_parent>(annotated.arrays), node, 1) : 0;
+            // same orientation as the depth-first-search
+            REQUIRE(csr.parent(node)==(parent_edge ? random_graph.head(node, parent_edge) : 0));
+            if (parent_edge)
+                REQUIRE(forest.get(annotated.get_pos(node, parent_edge)));
+            for (uint64_t pos=1; pos<=csr.children(node); pos++)
+                REQUIRE(csr.parent(csr.child(node, pos))==node);
+            children += csr.children(node);
+        }
+        REQUIRE(children==random_graph.n()-components);
+        REQUIRE(csr.copy().memory_usage()==csr.memory_usage());
+        const edge_layout_t layout = edge_layout(random_graph);
+        REQUIRE(layout.size()==annotated.size());
+        for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+            for (SFL_POS_SIZE edge=1; edge<=random_graph.deg(node); edge++)
+                REQUIRE(layout.get_pos(node, edge)==annotated.get_pos(node, edge));
+        }
+        RSBitmap wrong_size(annotated.size()+1);
+        REQUIRE_THROWS(ForestCSR(random_graph, wrong_size));
+    }
+}
+
+TEST_CASE( "Incremental blocks", "[cutvertices][dynamic]" ) {
+    for (uint64_t seed=1; seed<=5; seed++){
+        CAPTURE(seed);
+        SFLGraph graph = SFLGraph::create_erdos_renyi(200, 0.8/200, seed);
+        annotated_edges_t annotated = annotate_edges(graph);
+        IncrementalBlocks incremental(graph, annotated);
+        std::mt19937_64 gen(seed);
+        for (int round=0; round<=400; round++){
+            if (round%20==0){
+                CAPTURE(round);
+                annotated = annotate_edges(graph);
+                const RSBitmap cut = cutvertices(graph, annotated);
+                const BlockLabels labels = biconnected_labels(graph, annotated);
+                REQUIRE(incremental.cutvertex_count()==cut.ones());
+                REQUIRE(incremental.blocks()==labels.blocks());
+                const RSBitmap incremental_cut = incremental.cutvertices();
+                // both numberings describe the same partition of the tree edges
+                std::map<uint64_t, uint64_t> to_labels, from_labels;
+                for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+                    CAPTURE(node);
+                    REQUIRE(incremental_cut.get(node)==cut.get(node));
+                    SFL_ID_SIZE parent = incremental.parent(node);
+                    if (parent==0)
+                        continue;
+                    SFL_POS_SIZE edge = graph.find_edge(node, parent);
+                    REQUIRE(edge!=0);
+                    uint64_t block = incremental.block(node);
+                    uint64_t label = labels.block_of_edge(graph, node, edge);
+                    REQUIRE((block==0)==(label==0));
+                    if (block==0)
+                        continue;
+                    REQUIRE(to_labels.emplace(block, label).first->second==label);
+                    REQUIRE(from_labels.emplace(label, block).first->second==block);
+                }
+            }
+            SFL_ID_SIZE node1 = gen()%graph.n()+1;
+            SFL_ID_SIZE node2 = gen()%graph.n()+1;
+            if (node1==node2 || graph.find_edge(node1, node2)!=0)
+                continue;
+            graph.add_edge(node1, node2);
+            incremental.insert(node1, node2);
+        }
+        IncrementalBlocks copied = incremental.copy();
+        REQUIRE(copied.blocks()==incremental.blocks());
+        REQUIRE(copied.memory_usage()==incremental.memory_usage());
+    }
+}
+
+// maximal id difference of adjacent nodes
+static SFL_ID_SIZE bandwidth(const SFLGraph &graph){
+    SFL_ID_SIZE ret=0;
+    for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+        for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++)
+            ret = std::max(ret, node>graph.head(node, edge) ? node-graph.head(node, edge) : graph.head(node, edge)-node);
+    }
+    return ret;
+}
+
+TEST_CASE( "Node relabeling", "[SFLGraph][relabel]" ) {
+    // grid with shuffled ids
+    SFLGraph grid = SFLGraph::create_grid(30, 30);
+    std::vector<SFL_ID_SIZE> shuffled(grid.n());
+    for (SFL_ID_SIZE node=1; node<=grid.n(); node++)
+        shuffled[node-1] = node;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(3));
+    BitPackedArray shuffle_ids(grid.n(), BitPackedArray::calc_width(grid.n()));
+    for (SFL_ID_SIZE node=1; node<=grid.n(); node++)
+        shuffle_ids.set(node, shuffled[node-1]);
+    SFLGraph shuffled_grid = SFLGraph::create_relabeled(grid, shuffle_ids);
+    REQUIRE(bandwidth(shuffled_grid)>300);
+    REQUIRE(bandwidth(relabel(shuffled_grid, relabel_rcm).graph())<=2*30);
+    REQUIRE(bandwidth(relabel(shuffled_grid, relabel_bfs).graph())<=2*30);
+    // no permutation
+    BitPackedArray invalid(grid.n(), BitPackedArray::calc_width(grid.n()));
+    REQUIRE_THROWS(SFLGraph::create_relabeled(grid, invalid));
+
+    SFLGraph random_graph = SFLGraph::create_erdos_renyi(500, 2.0/500, 5);
+    annotated_edges_t annotated = annotate_edges(random_graph);
+    const RSBitmap cut = cutvertices(random_graph, annotated);
+    std::vector<std::vector<SFL_ID_SIZE>> components = biconnected_components(random_graph, annotated);
+    for (auto &component: components)
+        std::sort(component.begin(), component.end());
+    std::sort(components.begin(), components.end());
+    for (relabel_order order: {relabel_bfs, relabel_rcm, relabel_degree}){
+        CAPTURE(order);
+        const RelabeledGraph relabeled = relabel(random_graph, order);
+        const SFLGraph &graph = relabeled.graph();
+        REQUIRE(graph.n()==random_graph.n());
+        for (SFL_ID_SIZE node=1; node<=graph.n(); node++){
+            REQUIRE(relabeled.new_id(relabeled.old_id(node))==node);
+            REQUIRE(graph.deg(node)==random_graph.deg(relabeled.old_id(node)));
+            for (SFL_POS_SIZE edge=1; edge<=graph.deg(node); edge++){
+                AdjEntry mate_ = random_graph.mate(relabeled.old_id(node), edge);
+                REQUIRE(graph.mate(node, edge)==AdjEntry(relabeled.new_id(std::get<0>(mate_)), std::get<1>(mate_)));
+            }
+            if (order==relabel_degree && node>1)
+                REQUIRE(graph.deg(node-1)>=graph.deg(node));
+        }
+        annotated_edges_t relabeled_annotated = annotate_edges(graph);
+        const RSBitmap relabeled_cut = cutvertices(relabeled, relabeled_annotated);
+        REQUIRE(relabeled_cut.ones()==cut.ones());
+        for (SFL_ID_SIZE node=1; node<=graph.n(); node++)
+            REQUIRE(relabeled_cut.get(node)==cut.get(node));
+        std::vector<std::vector<SFL_ID_SIZE>> relabeled_components = biconnected_components(relabeled, relabeled_annotated);
+        for (auto &component: relabeled_components)
+            std::sort(component.begin(), component.end());
+        std::sort(relabeled_components.begin(), relabeled_components.end());
+        REQUIRE(relabeled_components==components);
+        REQUIRE(relabeled.memory_usage()>graph.memory_usage());
+    }
+}
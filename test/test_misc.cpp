@@ -2,8 +2,10 @@
 #include "thirdparty/Catch2/include/catch.hpp"
 
 #include "../src/misc.hpp"
+#include "../src/counters.hpp"
 #include <string>
 #include <vector>
+#include <thread>
 
 TEST_CASE( "ConstTimeArray") {
     SECTION("Basic"){
@@ -22,6 +24,35 @@ TEST_CASE( "ConstTimeArray") {
         REQUIRE(array2.get(3312)==1);
         REQUIRE(array2.get(12)==74722);
         REQUIRE(array2.get(1)==6);
+        array2.clear();
+        REQUIRE(array2.get(12)==1);
+        REQUIRE_FALSE(array2.is_init(1));
+        array2.set(12, 3);
+        REQUIRE(array2.get(12)==3);
+    }
+    SECTION("position widths"){
+        // uint16_t and uint32_t position types
+        for (uint64_t n: {UINT8_MAX+1ull, UINT16_MAX+1ull}){
+            ConstTimeArray<uint64_t> t_array(n, 3);
+            REQUIRE(t_array.n()==n);
+            t_array.set(n, 7);
+            t_array.set(UINT8_MAX, 8);
+            REQUIRE(t_array.is_init(n));
+            REQUIRE_FALSE(t_array.is_init(2));
+            ConstTimeArray<uint64_t> array2 = t_array.copy();
+            array2.set(1, 9);
+            REQUIRE(array2.get(n)==7);
+            REQUIRE(array2.get(UINT8_MAX)==8);
+            REQUIRE(array2.get(1)==9);
+            REQUIRE(t_array.get(1)==3);
+            t_array = std::move(array2);
+            REQUIRE(t_array.get(1)==9);
+            REQUIRE(t_array.space_report().components[1].second==2*n*(n>UINT16_MAX ? 4 : 2));
+        }
+        ConstTimeArray<uint32_t> empty(0, 1);
+        REQUIRE(empty.n()==0);
+        REQUIRE(empty.get(1)==1);
+        REQUIRE(empty.memory_usage()==0);
     }
     SECTION("Bool"){
         ConstTimeArray<bool> t_array(12, true);
@@ -55,6 +86,109 @@ TEST_CASE( "ConstTimeArray") {
     }
 }
 
+TEST_CASE( "InPlaceConstTimeArray") {
+    SECTION("Basic"){
+        InPlaceConstTimeArray<uint32_t> t_array(13, 1);
+        REQUIRE(t_array.n()==13);
+        REQUIRE(t_array.get(1)==1);
+        REQUIRE(t_array.get(13)==1);
+        t_array.set(13, 5);
+        t_array.set(12, 6);
+        t_array.set(1, 7);
+        REQUIRE(t_array.get(9923)==1);
+        REQUIRE(t_array.get(13)==5);
+        REQUIRE(t_array.get(12)==6);
+        REQUIRE(t_array.get(11)==1);
+        REQUIRE(t_array.get(2)==1);
+        REQUIRE(t_array.get(1)==7);
+        CHECK_THROWS(t_array.set(14, 1));
+        // no pointer arrays
+        REQUIRE(t_array.memory_usage()==12*sizeof(uint32_t));
+        InPlaceConstTimeArray<uint32_t> array2 = t_array.copy();
+        array2.set(12, 8);
+        REQUIRE(t_array.get(12)==6);
+        InPlaceConstTimeArray<uint32_t> array3 = std::move(array2);
+        REQUIRE(array3.get(12)==8);
+        REQUIRE(array3.get(1)==7);
+        REQUIRE(array3.get(13)==5);
+        array3.clear();
+        for (uint64_t pos=1; pos<=13; pos++)
+            REQUIRE(array3.get(pos)==1);
+        array3.set(2, 4);
+        REQUIRE(array3.get(2)==4);
+        REQUIRE(array3.get(1)==1);
+    }
+    SECTION("compare with vector"){
+        // small values are often block ids and create chains by accident
+        for (uint64_t n: {1ull, 2ull, 7ull, 64ull, 255ull}){
+            CAPTURE(n);
+            InPlaceConstTimeArray<uint8_t> t_array(n, 3);
+            std::vector<uint8_t> expected(n, 3);
+            uint64_t state = n;
+            for (uint64_t counter=0; counter<20*n; counter++){
+                state = state*6364136223846793005ull+1442695040888963407ull;
+                uint64_t pos = (state>>33)%n+1;
+                uint8_t value = (state>>13)%(n/2+2);
+                t_array.set(pos, value);
+                expected[pos-1] = value;
+                if (counter%(5*n+3)==5*n){
+                    t_array.clear();
+                    std::fill(expected.begin(), expected.end(), 3);
+                }
+                if (counter%7==0){
+                    for (uint64_t check=1; check<=n; check++){
+                        CAPTURE(counter, check);
+                        REQUIRE(t_array.get(check)==expected[check-1]);
+                    }
+                }
+            }
+            for (uint64_t check=1; check<=n; check++)
+                REQUIRE(t_array.get(check)==expected[check-1]);
+        }
+    }
+}
+
+TEST_CASE( "BitPackedArray", "[packed]" ) {
+    SECTION("Basic"){
+        REQUIRE(BitPackedArray::calc_width(0)==1);
+        REQUIRE(BitPackedArray::calc_width(1)==1);
+        REQUIRE(BitPackedArray::calc_width(2)==2);
+        REQUIRE(BitPackedArray::calc_width(255)==8);
+        REQUIRE(BitPackedArray::calc_width(256)==9);
+        REQUIRE(BitPackedArray::calc_width(-1ull)==64);
+        BitPackedArray packed(100, 7);
+        REQUIRE(packed.n()==100);
+        REQUIRE(packed.width()==7);
+        REQUIRE(packed.blocks()==11);
+        REQUIRE(packed.get(1)==0);
+        REQUIRE(packed.get(0)==0);
+        REQUIRE(packed.get(101)==0);
+        CHECK_THROWS(packed.set(101, 1));
+        CHECK_THROWS(packed.set(1, 128));
+        for (uint64_t c=1; c<=packed.n(); c++){
+            packed.set(c, (c*13)%128);
+        }
+        for (uint64_t c=1; c<=packed.n(); c++){
+            CAPTURE(c);
+            REQUIRE(packed.get(c)==(c*13)%128);
+        }
+        // test compatibility to move, doesn't compile or crash otherwise
+        BitPackedArray packedmove = std::move(packed);
+        REQUIRE(packedmove.get(10)==130%128);
+        BitPackedArray packedcopy = packedmove.copy();
+        packedcopy.set(10, 0);
+        REQUIRE(packedmove.get(10)==130%128);
+        REQUIRE(packedcopy.get(10)==0);
+    }
+    SECTION("full width"){
+        BitPackedArray packed(3, 64);
+        packed.set(2, 0xADF1EAEEF1FBF1FAull);
+        REQUIRE(packed.get(1)==0);
+        REQUIRE(packed.get(2)==0xADF1EAEEF1FBF1FAull);
+        REQUIRE(packed.get(3)==0);
+    }
+}
+
 TEST_CASE( "RSBitmap operations", "[succinct]" ) {
     SECTION("Construct"){
         RSBitmap rsb(200);
@@ -221,6 +355,34 @@ TEST_CASE( "RSBitmap operations", "[succinct]" ) {
     }
 
 
+    SECTION("clear and make dynamic"){
+        RSBitmap rsb(64*40);
+        rsb.set(3, true);
+        rsb.set(64*20, true);
+        rsb.set(64*40, true);
+        rsb.clear();
+        REQUIRE(rsb.ones()==0);
+        REQUIRE(rsb.get(3)==false);
+        REQUIRE(rsb.next_one(1)==0);
+        rsb.set(64*20+1, true);
+        REQUIRE(rsb.get(64*20)==false);
+        REQUIRE(rsb.select(0)==64*20+1);
+        rsb.set(7, true);
+        rsb.make_static();
+        rsb.make_dynamic();
+        REQUIRE_FALSE(rsb.is_static());
+        REQUIRE(rsb.ones()==2);
+        REQUIRE(rsb.rank(64*20+1)==1);
+        REQUIRE(rsb.select(1)==64*20+1);
+        rsb.flip(7);
+        REQUIRE(rsb.rank(64*40)==1);
+        rsb.make_static();
+        rsb.clear();
+        REQUIRE_FALSE(rsb.is_static());
+        REQUIRE(rsb.ones()==0);
+        REQUIRE(rsb.get(64*20+1)==false);
+    }
+
     SECTION("Fill and check"){
         RSBitmap bit1(500);
         // fill and check
@@ -268,6 +430,11 @@ TEST_CASE( "SegmentedArray") {
         REQUIRE(segments.segment_size(3)==2);
         REQUIRE(segments.segment_size(4)==0);
         REQUIRE(segments.segment_size(5)==4);
+        segments.reset<0>();
+        REQUIRE(segments.get<0>(segments.get_pos(1, 1))==123);
+        REQUIRE(segments.get<0>(segments.get_pos(3, 1))==123);
+        segments.set<0>(segments.get_pos(1, 12), 8);
+        REQUIRE(segments.get<0>(segments.get_pos(1, 12))==8);
     }
     SECTION("boolspecialized"){
         std::vector<uint64_t> t({12, 0, 2, 0, 4});
@@ -288,8 +455,13 @@ TEST_CASE( "SegmentedArray") {
         REQUIRE(segments.ones_segment(std::get<0>(segments.arrays), 1)==5);
         REQUIRE(segments.ones_segment(std::get<0>(segments.arrays), 5)==2);
 
-
-
+        std::get<0>(segments.arrays).make_static();
+        segments.reset<0>();
+        REQUIRE_FALSE(std::get<0>(segments.arrays).is_static());
+        REQUIRE(std::get<0>(segments.arrays).ones()==0);
+        REQUIRE(segments.get<0>(segments.get_pos(1, 1))==false);
+        segments.set<0>(segments.get_pos(5, 4), true);
+        REQUIRE(segments.ones_segment(std::get<0>(segments.arrays), 5)==1);
     }
 }
 
@@ -410,4 +582,74 @@ TEST_CASE( "SpinStack", "Stack" ) {
         REQUIRE(sp.empty()==true);
 
     }
+    SECTION("size is not a power of two"){
+        SpinStack<uint64_t> sp(5);
+        for (uint64_t round=0; round<20; round++){
+            CAPTURE(round);
+            // move the window around the buffer
+            for (uint64_t c=0; c<5; c++)
+                REQUIRE_NOTHROW(sp.push_top(round*10+c));
+            REQUIRE(sp.full()==true);
+            REQUIRE(sp.size()==5);
+            REQUIRE(sp.drop_front(3)==3);
+            REQUIRE(sp.peek()==round*10+4);
+            REQUIRE_NOTHROW(sp.push_bottom(round*10+2));
+            REQUIRE(sp.size()==3);
+            REQUIRE(sp.pop()==round*10+4);
+            REQUIRE(sp.pop()==round*10+3);
+            REQUIRE(sp.pop()==round*10+2);
+            REQUIRE(sp.empty()==true);
+        }
+    }
+}
+
+TEST_CASE( "PackedSpinStack", "Stack" ) {
+    REQUIRE(PackedSpinStack::fits(UINT32_MAX, UINT32_MAX));
+    REQUIRE_FALSE(PackedSpinStack::fits(UINT64_MAX, 2));
+    // 10 bits node, 5 bits edge
+    PackedSpinStack sp(6, 1000, 17);
+    REQUIRE(sp.width()==15);
+    REQUIRE(sp.empty()==true);
+    REQUIRE(sp.drop_front(3)==0);
+    for (uint64_t round=0; round<10; round++){
+        CAPTURE(round);
+        for (uint64_t c=0; c<6; c++)
+            REQUIRE_NOTHROW(sp.push_top(std::make_tuple(1000-round*10-c, c+1)));
+        REQUIRE(sp.full()==true);
+        REQUIRE(sp.drop_front(4)==4);
+        REQUIRE(sp.size()==2);
+        REQUIRE_NOTHROW(sp.push_bottom(std::make_tuple(1, 17)));
+        REQUIRE(sp.peek()==std::make_tuple(1000-round*10-5, 6));
+        REQUIRE(sp.pop()==std::make_tuple(1000-round*10-5, 6));
+        REQUIRE(sp.pop()==std::make_tuple(1000-round*10-4, 5));
+        REQUIRE(sp.pop()==std::make_tuple(1, 17));
+        REQUIRE(sp.empty()==true);
+    }
+    PackedSpinStack spmove = std::move(sp);
+    REQUIRE(sp.empty()==true);
+    REQUIRE(spmove.n==6);
+}
+
+TEST_CASE( "Instrumentation counters", "[counters]" ) {
+    counters_reset();
+    RSBitmap rsb(1000);
+    rsb.set(500, true);
+    REQUIRE(rsb.rank(600)==1);
+    // other threads are summed up, also after they finished
+    std::thread worker([&rsb](){
+        rsb.rank(700);
+        rsb.rank(800);
+    });
+    worker.join();
+    auto snapshot = counters_snapshot();
+    REQUIRE(snapshot.size()==counter_amount);
+    REQUIRE(snapshot[counter_rank].first==counter_name(counter_rank));
+    if (counters_enabled()){
+        REQUIRE(snapshot[counter_rank].second==3);
+        REQUIRE(snapshot[counter_init_slate].second==1);
+    } else {
+        REQUIRE(snapshot[counter_rank].second==0);
+    }
+    counters_reset();
+    REQUIRE(counters_snapshot()[counter_rank].second==0);
 }
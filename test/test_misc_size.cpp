@@ -66,3 +66,58 @@ TEST_CASE( "RSBitmap Size", "[BitSize]") {
     bit3.set_n(local_graph->n()*63, 5, 17);
     REQUIRE(bit3.get_n(local_graph->n()*63, 5) ==  17);
 }
+
+TEST_CASE( "Space accounting", "[SpaceReport]") {
+    SECTION("ConstTimeArray"){
+        ConstTimeArray<uint32_t> t_array(100, 1);
+        SpaceReport report = t_array.space_report();
+        REQUIRE(report.components.size()==2);
+        REQUIRE(report.components[0].first=="array");
+        REQUIRE(report.components[0].second==400);
+        // two uint8_t pointer arrays
+        REQUIRE(report.components[1].second>=200);
+        REQUIRE(t_array.memory_usage()==report.total());
+    }
+    SECTION("RSBitmap"){
+        RSBitmap bitmap(64*100);
+        SpaceReport report = bitmap.space_report();
+        REQUIRE(report.components[0].first=="array");
+        REQUIRE(report.components[0].second==800);
+        REQUIRE(report.components[1].first=="slates");
+        REQUIRE(report.components.back().first=="slates.array");
+        REQUIRE(bitmap.memory_usage()==report.total());
+        bitmap.set(5, true);
+        bitmap.make_static();
+        SpaceReport report_static = bitmap.space_report();
+        REQUIRE(report_static.components.size()==2);
+        REQUIRE(report_static.components[1].first=="rank9sel");
+        REQUIRE(RSBitmap(0).memory_usage()==0);
+    }
+    SECTION("Packed structures"){
+        BitPackedArray packed(100, 7);
+        REQUIRE(packed.memory_usage()==11*8);
+        SpinStack<uint64_t> stack(5);
+        REQUIRE(stack.memory_usage()==8*8);
+        PackedSpinStack packed_stack(5, 255, 255);
+        REQUIRE(packed_stack.memory_usage()==2*8);
+    }
+    SECTION("SegmentedArray and SFLGraph"){
+        SFLGraph local_graph = SFLGraph::create(9, graph1_edges, 9);
+        // nodes, edges and the amount of nodes per degree
+        REQUIRE(local_graph.space_report().components.size()==3);
+        REQUIRE(local_graph.space_report().components[2].first=="degrees");
+        REQUIRE(local_graph.memory_usage()>=9*sizeof(sfl_node)+18*sizeof(AdjEntry));
+        SegmentedArray<bool, uint32_t> segmented(local_graph.begin_deg(), local_graph.end_deg(), false, 0);
+        SpaceReport report = segmented.space_report();
+        REQUIRE(report.components[0].first=="segments.array");
+        bool found=false;
+        for (const auto &component: report.components){
+            if (component.first=="arrays.1.array"){
+                REQUIRE(component.second==18*4);
+                found=true;
+            }
+        }
+        REQUIRE(found);
+        REQUIRE(segmented.memory_usage()==report.total());
+    }
+}
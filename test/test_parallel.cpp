@@ -0,0 +1,172 @@
+#include "thirdparty/Catch2/include/catch.hpp"
+
+#include "../src/fgraph.hpp"
+#include "../src/graph.hpp"
+#include "../src/parallel.hpp"
+#include "test_main.hpp"
+
+TEST_CASE( "ConcurrentUnionFind", "[unionfind]" ) {
+    ConcurrentUnionFind sets(10);
+    REQUIRE(sets.n()==10);
+    REQUIRE(sets.components()==10);
+    REQUIRE(sets.find(0)==0);
+    REQUIRE(sets.find(11)==0);
+    REQUIRE(sets.unite(3, 7)==true);
+    REQUIRE(sets.unite(7, 3)==false);
+    REQUIRE(sets.unite(9, 7)==true);
+    REQUIRE(sets.unite(10, 2)==true);
+    REQUIRE(sets.components()==7);
+    // lowest element represents the set
+    REQUIRE(sets.find(9)==3);
+    REQUIRE(sets.find(10)==2);
+    REQUIRE(sets.same_component(9, 3)==true);
+    REQUIRE(sets.same_component(9, 2)==false);
+    const BitPackedArray& labels = sets.flatten();
+    REQUIRE(labels.width()==3);
+    REQUIRE(labels.get(1)==1);
+    REQUIRE(labels.get(2)==2);
+    REQUIRE(labels.get(10)==2);
+    REQUIRE(labels.get(3)==3);
+    REQUIRE(labels.get(7)==3);
+    REQUIRE(labels.get(9)==3);
+    REQUIRE(labels.get(6)==6);
+    REQUIRE(labels.get(8)==7);
+}
+
+TEST_CASE( "Parallel connected components", "[unionfind][connected_components]" ) {
+    std::vector<std::shared_ptr<SFLGraph>> graphs;
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(10, graph1_edges, 9)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(9, graph2_edges, 11)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(16, graph3_edges, 20)));
+#ifdef USE_BOOST
+    std::stringstream oldgraph_stream(oldgraph, std::ios::in);
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_from_dot(oldgraph_stream)));
+#endif
+    for (auto &local_graph: graphs){
+        CAPTURE(local_graph->n());
+        const BitPackedArray& labels = connected_components(*local_graph);
+        for (unsigned threads: {1, 4}){
+            CAPTURE(threads);
+            const BitPackedArray& labels_parallel = connected_components_parallel(*local_graph, threads);
+            REQUIRE(labels_parallel.width()==labels.width());
+            for (SFL_ID_SIZE node=1; node<=local_graph->n(); node++){
+                CAPTURE(node);
+                REQUIRE(labels_parallel.get(node)==labels.get(node));
+            }
+        }
+    }
+    RSBitmap removed(10);
+    removed.set(3, true);
+    SFLGraph local_graph = SFLGraph::create(10, graph1_edges, 9);
+    const BitPackedArray& labels = connected_components(local_graph, removed);
+    const BitPackedArray& labels_parallel = connected_components_parallel(local_graph, 2, removed);
+    for (SFL_ID_SIZE node=1; node<=local_graph.n(); node++){
+        CAPTURE(node);
+        REQUIRE(labels_parallel.get(node)==labels.get(node));
+    }
+    // removed nodes don't widen the labels
+    SFLGraph path = SFLGraph::create_path(16);
+    RSBitmap removed_path(16);
+    for (SFL_ID_SIZE node=3; node<=16; node++)
+        removed_path.set(node, true);
+    const BitPackedArray& path_labels = connected_components(path, removed_path);
+    const BitPackedArray& path_labels_parallel = connected_components_parallel(path, 2, removed_path);
+    REQUIRE(path_labels_parallel.width()==path_labels.width());
+    REQUIRE(path_labels_parallel.width()==1);
+    REQUIRE(path_labels_parallel.get(2)==1);
+}
+
+TEST_CASE( "Parallel spanning forest", "[unionfind][spanning_forest]" ) {
+    for (uint64_t seed=1; seed<=5; seed++){
+        CAPTURE(seed);
+        SFLGraph random_graph = SFLGraph::create_erdos_renyi(20000, 1.2/20000, seed);
+        uint64_t components = connected_components(random_graph, [](SFL_ID_SIZE, bool){});
+        for (unsigned threads: {1, 4}){
+            CAPTURE(threads);
+            const RSBitmap forest = spanning_forest_parallel(random_graph, threads);
+            REQUIRE(forest.ones()==2*(random_graph.n()-components));
+            // tree edges never close a cycle
+            ConcurrentUnionFind sets(random_graph.n());
+            uint64_t pos=0;
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++){
+                for (SFL_POS_SIZE edge=1; edge<=random_graph.deg(node); edge++){
+                    pos++;
+                    AdjEntry mate_ = random_graph.mate(node, edge);
+                    if (forest.get(pos) && node<std::get<0>(mate_))
+                        REQUIRE(sets.unite(node, std::get<0>(mate_)));
+                }
+            }
+            REQUIRE(sets.components()==components);
+            const ForestCSR csr(random_graph, forest);
+            for (SFL_ID_SIZE node=1; node<=random_graph.n(); node++)
+                REQUIRE((csr.parent(node)==0)==(sets.find(node)==node));
+        }
+    }
+    SFLGraph cycle = SFLGraph::create_cycle(10);
+    RSBitmap removed(10);
+    removed.set(3, true);
+    REQUIRE(spanning_forest_parallel(cycle, 2, removed).ones()==2*8);
+    // no edges
+    SFLGraph single = SFLGraph::create_path(1);
+    const RSBitmap forest = spanning_forest_parallel(single, 2);
+    REQUIRE(forest.ones()==0);
+    REQUIRE(ForestCSR(single, forest).parent(1)==0);
+}
+
+TEST_CASE( "Parallel biconnected components", "[biconnected_components]" ) {
+    std::vector<std::shared_ptr<SFLGraph>> graphs;
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(10, graph1_edges, 9)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(9, graph2_edges, 11)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create(16, graph3_edges, 20)));
+#ifdef USE_BOOST
+    std::stringstream oldgraph_stream(oldgraph, std::ios::in);
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_from_dot(oldgraph_stream)));
+#endif
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_clique_chain(200, 5)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_grid(30, 40)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_star(5000)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_path(5000)));
+    // many small blocks and bridges, and bigger than one chunk
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_erdos_renyi(10000, 1.5/10000, 3)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_erdos_renyi(5000, 4.0/5000, 4)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_geometric(5000, 0.015, 5)));
+    graphs.push_back(std::make_shared<SFLGraph>(SFLGraph::create_rmat(12, 4, 6)));
+    for (auto &local_graph: graphs){
+        CAPTURE(local_graph->n());
+        // without and with a few removed nodes
+        for (bool remove: {false, true}){
+            CAPTURE(remove);
+            RSBitmap removed(local_graph->n());
+            if (remove){
+                for (uint64_t counter=1; counter<=3; counter++)
+                    removed.set((counter*local_graph->n())/4+1, true);
+            }
+            annotated_edges_t annotated = annotate_edges(*local_graph, removed);
+            const BlockLabels labels = biconnected_labels(*local_graph, annotated, removed);
+            const RSBitmap cut = cutvertices(*local_graph, annotated, removed);
+            for (unsigned threads: {1, 4}){
+                CAPTURE(threads);
+                const BlockLabels labels_parallel = biconnected_labels_parallel(*local_graph, threads, removed);
+                REQUIRE(labels_parallel.blocks()==labels.blocks());
+                for (SFL_ID_SIZE node=1; node<=local_graph->n(); node++){
+                    CAPTURE(node);
+                    REQUIRE(labels_parallel.block(node)==labels.block(node));
+                    REQUIRE(labels_parallel.top_blocks(node)==labels.top_blocks(node));
+                    if (labels.top_blocks(node)>0)
+                        REQUIRE(labels_parallel.top_block(node, 1)==labels.top_block(node, 1));
+                    // nodes in more than one block are cut vertices (bridges are no blocks)
+                    if (labels_parallel.top_blocks(node)+(labels_parallel.block(node)>0)>=2)
+                        REQUIRE(cut.get(node));
+                }
+            }
+        }
+    }
+    // removed nodes split the graph
+    SFLGraph cycle = SFLGraph::create_cycle(10);
+    RSBitmap removed(10);
+    removed.set(5, true);
+    const BlockLabels labels = biconnected_labels_parallel(cycle, 2, removed);
+    REQUIRE(labels.blocks()==0);
+    removed.set(5, false);
+    REQUIRE(biconnected_labels_parallel(cycle, 2, removed).blocks()==1);
+}